@@ -0,0 +1,1044 @@
+#include "batch.hpp"
+
+#include "blh_simd.hpp"
+#include "prof.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <condition_variable>
+#include <cstdlib>
+#include <exception>
+#include <iostream>
+#include <limits>
+#include <mutex>
+#include <thread>
+
+namespace iss_sgp4_json {
+
+static constexpr double       kSecD   = 86400.0;           // 秒数(1日分)
+static constexpr long long    kNsecD  = 86400000000000LL;  // ナノ秒数(1日分)
+static constexpr long long    kBatch  = 4096;              // 一括計算の最大件数
+static constexpr unsigned int kWindow = 4;  // 計算済み未出力区間の上限(スレッド毎)
+static constexpr double       kMinD   = 1440.0;            // 分数(1日分)
+static constexpr double       kEccMax = 0.999;             // 離心率の上限(補間間隔の計算用)
+static constexpr double       kSeed   = 600.0;  // 間引きの初期分割の間隔(秒)
+static constexpr double       kHermSafe = 0.5;  // Hermite 補間の誤差の見積もりに対する余裕(上限に対する比)
+static constexpr unsigned int kChkA[] = {4, 2, 6, 1, 3, 5, 7};
+                                                 // 間引きの検証点(区間の 1/8 単位; 中点から)
+static constexpr double       kReKm   = 6378.137;          // 地球の赤道半径(km)
+static constexpr double       kPi180  = atan(1.0) * 4.0 / 180.0;  // 円周率 / 180.0
+
+/*
+ * @brief       3次 Hermite 補間（節点の間）
+ *              * 節点(m 件毎と末尾)の位置・速度から、その間の計算時刻の
+ *                位置・速度を求める（速度は補間多項式の微分）
+ *              * 節点の t, x .. vz は設定済みとする
+ *
+ * @param[in]   節点の間隔(計算回数) (unsigned int)
+ * @param[ref]  軌道 (Trajectory)
+ */
+static void interp_hermite(unsigned int m, Trajectory& trj) {
+  unsigned int i;
+  unsigned int a;   // 節点(区間の始端)
+  unsigned int b;   // 節点(区間の終端)
+  double       dt;  // 節点の間の秒数
+  double       s;   // 区間内の位置(0 .. 1)
+  double       h00, h10, h01, h11;  // 位置の基底関数
+  double       g00, g10, g01, g11;  // 速度の基底関数(微分)
+
+  ProfTimer pt(Stage::kHerm, trj.n);
+  for (a = 0; a + 1 < trj.n; a = b) {
+    b  = std::min(a + m, trj.n - 1);
+    dt = trj.t[b] - trj.t[a];
+    for (i = a + 1; i < b; ++i) {
+      s   = (trj.t[i] - trj.t[a]) / dt;
+      h00 = (2.0 * s - 3.0) * s * s + 1.0;
+      h10 = ((s - 2.0) * s + 1.0) * s * dt;
+      h01 = (3.0 - 2.0 * s) * s * s;
+      h11 = (s - 1.0) * s * s * dt;
+      g00 = 6.0 * (s - 1.0) * s / dt;
+      g10 = (3.0 * s - 4.0) * s + 1.0;
+      g01 = -g00;
+      g11 = (3.0 * s - 2.0) * s;
+      trj.x[i]  = h00 * trj.x[a]  + h10 * trj.vx[a]
+                + h01 * trj.x[b]  + h11 * trj.vx[b];
+      trj.y[i]  = h00 * trj.y[a]  + h10 * trj.vy[a]
+                + h01 * trj.y[b]  + h11 * trj.vy[b];
+      trj.z[i]  = h00 * trj.z[a]  + h10 * trj.vz[a]
+                + h01 * trj.z[b]  + h11 * trj.vz[b];
+      trj.vx[i] = g00 * trj.x[a]  + g10 * trj.vx[a]
+                + g01 * trj.x[b]  + g11 * trj.vx[b];
+      trj.vy[i] = g00 * trj.y[a]  + g10 * trj.vy[a]
+                + g01 * trj.y[b]  + g11 * trj.vy[b];
+      trj.vz[i] = g00 * trj.z[a]  + g10 * trj.vz[a]
+                + g01 * trj.z[b]  + g11 * trj.vz[b];
+    }
+  }
+}
+
+/*
+ * @brief       TEME -> ECEF（位置・速度; 1計算時刻分）
+ *              * 回転行列・地球自転項の行列は Blh::gen_mtx_rw のもの
+ *                (v_ecef = 回転行列 * v_teme - 地球自転項の行列 * r_teme)
+ *
+ * @param[in]   回転行列(3x3) (Mtx3)
+ * @param[in]   地球自転項の行列(3x3) (Mtx3)
+ * @param[in]   計算時刻の index (unsigned int)
+ * @param[ref]  軌道 (Trajectory; x .. vz は設定済み)
+ */
+static inline void rotate(
+    const Mtx3& mtx_r, const Mtx3& mtx_w, unsigned int i, Trajectory& trj) {
+  trj.xe[i]  = mtx_r[0][0] * trj.x[i] + mtx_r[0][1] * trj.y[i]
+             + mtx_r[0][2] * trj.z[i];
+  trj.ye[i]  = mtx_r[1][0] * trj.x[i] + mtx_r[1][1] * trj.y[i]
+             + mtx_r[1][2] * trj.z[i];
+  trj.ze[i]  = mtx_r[2][0] * trj.x[i] + mtx_r[2][1] * trj.y[i]
+             + mtx_r[2][2] * trj.z[i];
+  trj.vxe[i] = mtx_r[0][0] * trj.vx[i] + mtx_r[0][1] * trj.vy[i]
+             + mtx_r[0][2] * trj.vz[i]
+             - (mtx_w[0][0] * trj.x[i] + mtx_w[0][1] * trj.y[i]
+             +  mtx_w[0][2] * trj.z[i]);
+  trj.vye[i] = mtx_r[1][0] * trj.vx[i] + mtx_r[1][1] * trj.vy[i]
+             + mtx_r[1][2] * trj.vz[i]
+             - (mtx_w[1][0] * trj.x[i] + mtx_w[1][1] * trj.y[i]
+             +  mtx_w[1][2] * trj.z[i]);
+  trj.vze[i] = mtx_r[2][0] * trj.vx[i] + mtx_r[2][1] * trj.vy[i]
+             + mtx_r[2][2] * trj.vz[i]
+             - (mtx_w[2][0] * trj.x[i] + mtx_w[2][1] * trj.y[i]
+             +  mtx_w[2][2] * trj.z[i]);
+}
+
+/*
+ * @brief       1計算時刻の計算（間引き用）
+ *              * propagate_batch・transform_batch の1件分
+ *                (SGP4, TEME -> ECEF -> BLH, 速さ)
+ *              * 軌道の t[i] は設定済みとする
+ *
+ * @param[ref]  SGP4 (Sgp4)
+ * @param[ref]  衛星情報 (Satellite)
+ * @param[ref]  BLH 変換 (Blh)
+ * @param[in]   UT1(計算開始) (timespec)
+ * @param[in]   TAI(計算開始) (timespec)
+ * @param[in]   計算時刻の index (unsigned int)
+ * @param[ref]  軌道 (Trajectory)
+ */
+static void eval_point(
+    Sgp4& o_s, Satellite& sat, Blh& o_b,
+    struct timespec ut1, struct timespec tai, unsigned int i,
+    Trajectory& trj) {
+  PvTeme   teme;
+  Mtx3     mtx_r;
+  Mtx3     mtx_w;
+
+  teme = o_s.propagate(sat, ts_add(ut1, trj.t[i]));
+  trj.x[i]  = teme.r.x;
+  trj.y[i]  = teme.r.y;
+  trj.z[i]  = teme.r.z;
+  trj.vx[i] = teme.v.x;
+  trj.vy[i] = teme.v.y;
+  trj.vz[i] = teme.v.z;
+  o_b.set_time(ts_add(ut1, trj.t[i]), ts_add(tai, trj.t[i]));
+  o_b.gen_mtx_rw(mtx_r, mtx_w);
+  rotate(mtx_r, mtx_w, i, trj);
+  ecef2blh_batch(1, &trj.xe[i], &trj.ye[i], &trj.ze[i],
+                 &trj.lat[i], &trj.lon[i], &trj.h[i]);
+  trj.speed[i] = sqrt(trj.vx[i] * trj.vx[i] + trj.vy[i] * trj.vy[i]
+               + trj.vz[i] * trj.vz[i]);
+}
+
+/*
+ * @brief       経度の差(-180 .. 180°)
+ *
+ * @param[in]   経度(°) (double)
+ * @param[in]   経度(°; 基準) (double)
+ * @return      差(°) (double)
+ */
+static inline double lon_diff(double l, double l_0) {
+  double d = l - l_0;
+
+  if (d > 180.0)  { d -= 360.0; }
+  if (d < -180.0) { d += 360.0; }
+  return d;
+}
+
+/*
+ * @brief       線形補間(緯度・経度・高度)の誤差（間引き用）
+ *              * 残した計算時刻 a, b の間を緯度・経度(日付変更線をまたがない
+ *                向き)・高度それぞれ線形に補間した点と、指定の点との
+ *                距離（局所的な平面近似; 高緯度ほど経度の差が小さく見積もら
+ *                れないよう、緯度 i での東西方向の長さで換算）
+ *
+ * @param[in]   軌道 (Trajectory)
+ * @param[in]   残した計算時刻(始端; 軌道の index) (unsigned int)
+ * @param[in]   残した計算時刻(終端; 軌道の index) (unsigned int)
+ * @param[in]   区間内の位置 (double; 0 .. 1)
+ * @param[in]   緯度(°) (double)
+ * @param[in]   経度(°) (double)
+ * @param[in]   高度(km) (double)
+ * @return      誤差(km) (double)
+ */
+static double lin_err(
+    const Trajectory& trj, unsigned int a, unsigned int b, double s,
+    double lat, double lon, double h) {
+  double rr;  // 地心距離の目安(km)
+  double dn;  // 南北の差(km)
+  double de;  // 東西の差(km)
+  double dh;  // 高度の差(km)
+
+  rr = kReKm + h;
+  dn = (lat - (trj.lat[a] + s * (trj.lat[b] - trj.lat[a]))) * kPi180 * rr;
+  de = lon_diff(lon, trj.lon[a] + s * lon_diff(trj.lon[b], trj.lon[a]))
+     * kPi180 * rr * cos(lat * kPi180);
+  dh = h - (trj.h[a] + s * (trj.h[b] - trj.h[a]));
+  return sqrt(dn * dn + de * de + dh * dh);
+}
+
+/*
+ * @brief       間引きの誤差の判定（1計算時刻分）
+ *              * 未計算なら計算し、残した計算時刻 a, b の間の線形補間の
+ *                誤差が上限を越えるか判定する
+ *
+ * @param[ref]  SGP4 (Sgp4)
+ * @param[ref]  衛星情報 (Satellite)
+ * @param[ref]  BLH 変換 (Blh)
+ * @param[in]   UT1(計算開始) (timespec)
+ * @param[in]   TAI(計算開始) (timespec)
+ * @param[in]   誤差の上限(km) (double)
+ * @param[in]   計算時刻の index(始端; 残す) (unsigned int)
+ * @param[in]   計算時刻の index(終端; 残す) (unsigned int)
+ * @param[in]   計算時刻の index(判定する) (unsigned int)
+ * @param[ref]  軌道 (Trajectory)
+ * @param[ref]  状態一覧 (vector<char>; 0: 未計算, 1: 計算済み, 2: 残す)
+ * @return      上限を越えるか (bool)
+ */
+static bool over_tol(
+    Sgp4& o_s, Satellite& sat, Blh& o_b,
+    struct timespec ut1, struct timespec tai, double tol,
+    unsigned int a, unsigned int b, unsigned int q,
+    Trajectory& trj, std::vector<char>& st) {
+  if (st[q] == 0) {
+    eval_point(o_s, sat, o_b, ut1, tai, q, trj);
+    st[q] = 1;
+  }
+  return lin_err(trj, a, b, static_cast<double>(q - a) / (b - a),
+                 trj.lat[q], trj.lon[q], trj.h[q]) > tol;
+}
+
+/*
+ * @brief       間引きの再帰的な細分化
+ *              * 残した計算時刻 a, b の間を8等分する計算時刻(kChkA)を先に
+ *                検証し（上限を越える区間を早く見つけるため）、それらが上限
+ *                以内なら a, b の間の全計算時刻を検証する
+ *              * いずれかの線形補間の誤差が上限を越えるか、a, b の間で
+ *                日付変更線をまたぐ場合は、中点を残して前後を細分化する
+ *                （間引いた全計算時刻の誤差は上限以下になる; SGP4 の計算回数
+ *                 ではなく出力の件数を減らすためのもの）
+ *              * 計算済みの計算時刻は再計算しない
+ *
+ * @param[ref]  SGP4 (Sgp4)
+ * @param[ref]  衛星情報 (Satellite)
+ * @param[ref]  BLH 変換 (Blh)
+ * @param[in]   UT1(計算開始) (timespec)
+ * @param[in]   TAI(計算開始) (timespec)
+ * @param[in]   誤差の上限(km) (double)
+ * @param[in]   計算時刻の index(始端; 残す) (unsigned int)
+ * @param[in]   計算時刻の index(終端; 残す) (unsigned int)
+ * @param[ref]  軌道 (Trajectory)
+ * @param[ref]  状態一覧 (vector<char>; 0: 未計算, 1: 計算済み, 2: 残す)
+ */
+static void refine(
+    Sgp4& o_s, Satellite& sat, Blh& o_b,
+    struct timespec ut1, struct timespec tai, double tol,
+    unsigned int a, unsigned int b, Trajectory& trj, std::vector<char>& st) {
+  unsigned int q;   // 検証する計算時刻
+  unsigned int md;  // 中点
+  bool         sp;  // 細分化するか
+
+  if (b - a <= 1) { return; }
+  md = a + (b - a) / 2;
+  sp = std::abs(trj.lon[b] - trj.lon[a]) > 180.0;
+  for (unsigned int c : kChkA) {
+    if (sp) { break; }
+    q = a + (b - a) * c / 8;
+    if (q == a) { continue; }
+    sp = over_tol(o_s, sat, o_b, ut1, tai, tol, a, b, q, trj, st);
+  }
+  for (q = a + 1; q < b && !sp; ++q) {
+    sp = over_tol(o_s, sat, o_b, ut1, tai, tol, a, b, q, trj, st);
+  }
+  if (!sp) { return; }
+  if (st[md] == 0) { eval_point(o_s, sat, o_b, ut1, tai, md, trj); }
+  st[md] = 2;
+  refine(o_s, sat, o_b, ut1, tai, tol, a, md, trj, st);
+  refine(o_s, sat, o_b, ut1, tai, tol, md, b, trj, st);
+}
+
+/*
+ * @brief      件数変更
+ *             * 確保済みの領域は再利用する
+ *             * 間引き時の計算回(k)は空にする
+ *
+ * @param[in]  件数 (unsigned int)
+ */
+void Trajectory::resize(unsigned int n) {
+  this->n = n;
+  k.clear();
+  t.resize(n);
+  x.resize(n);
+  y.resize(n);
+  z.resize(n);
+  vx.resize(n);
+  vy.resize(n);
+  vz.resize(n);
+  xe.resize(n);
+  ye.resize(n);
+  ze.resize(n);
+  vxe.resize(n);
+  vye.resize(n);
+  vze.resize(n);
+  lat.resize(n);
+  lon.resize(n);
+  h.resize(n);
+  speed.resize(n);
+}
+
+/*
+ * @brief       一括計算の区間一覧作成
+ *              * 計算開始から1日毎に EOP を取得し、日データとする
+ *                (最初・最後の計算回の日の EOP がなければエラー終了する)
+ *              * 各日の計算回を TLE の切り替え・うるう秒適用の直前まで
+ *                (最大 kBatch 件)の区間に分割する
+ *              * TLE を指定しない場合は TLE の切り替えで分割しない
+ *                (区間の TLE は nullptr)
+ *
+ * @param[ref]  EOP (Eop)
+ * @param[ref]  うるう秒 (Dat)
+ * @param[in]   TLE (Tle*; nullptr 可)
+ * @param[in]   JST(計算開始) (timespec)
+ * @param[in]   計算期間(ナノ秒) (long long)
+ * @param[in]   計算間隔(ナノ秒) (long long)
+ * @param[out]  日データ一覧 (vector<BatchDay>)
+ * @param[out]  区間一覧 (vector<BatchRun>)
+ */
+void plan_batches(
+    Eop& o_e, Dat& o_d, Tle* o_t, struct timespec jst_s,
+    long long n_day, long long n_sec,
+    std::vector<BatchDay>& days, std::vector<BatchRun>& runs) {
+  long long       n_rec;           // 計算回数
+  long long       n_chk;           // 計算日数(1日未満の端数も1日と数える)
+  long long       c;               // loop index(日)
+  long long       k;               // loop index(計算回)
+  long long       k_e;             // loop index(計算回; 1日分の終端)
+  long long       k_r;             // loop index(計算回; 区間の終端)
+  double          j;               // 1日分の先頭からの経過秒
+  double          j_r;             // 1日分の先頭からの経過秒(区間の終端判定用)
+  struct timespec utc_wk;          // UTC(作業用)
+  struct timespec ut1_wk;          // UT1(作業用)
+  struct timespec dat_nxt = {0, 0};  // 次のうるう秒適用日時(UTC)
+  struct timespec tle_nxt;         // 次の TLE 切り替え日時(UT1)
+  int             dat = 0;         // DAT (= TAI - UTC)
+  EopRec          eop;             // EOP データ
+  BatchDay        day;             // 日データ
+  BatchRun        run;             // 区間
+
+  try {
+    n_rec = (n_day + n_sec - 1) / n_sec;
+    n_chk = (n_day + kNsecD - 1) / kNsecD;
+    tle_nxt = {std::numeric_limits<time_t>::max(), 0};
+    run.tle = nullptr;
+    days.clear();
+    runs.clear();
+
+    // 計算期間の EOP データの有無（最初・最後の計算回の日; 計算前に確認）
+    c = (n_rec - 1) * n_sec / kNsecD;
+    if (!o_e.has_eop(jst2utc(jst_s)) ||
+        !o_e.has_eop(jst2utc(ts_add(jst_s, c * kSecD)))) {
+      std::cerr << "[ERROR] EOP data could not be found for the calculation"
+                << " period!" << std::endl;
+      std::exit(EXIT_FAILURE);
+    }
+
+    // LOOP (日)
+    // * EOP, 極運動の回転行列は計算開始から1日毎に取得し直す
+    for (c = 0, k = 0; c < n_chk; ++c) {
+      // 1日分の先頭からの経過が1日未満となる計算回(計算回がなければ次の日へ)
+      k_e = std::min(n_rec, ((c + 1) * kNsecD + n_sec - 1) / n_sec);
+      if (k >= k_e) { continue; }
+      day.c   = c;
+      day.jst = ts_add(jst_s, c * kSecD);
+
+      // EOP データ取得
+      day.utc  = jst2utc(day.jst);
+      eop      = o_e.get_eop(day.utc);
+      day.pm_x = eop.pm_x;
+      day.pm_y = eop.pm_y;
+      day.lod  = eop.lod;
+      day.ut1  = utc2ut1(day.utc, eop.dut1);
+      day.tai  = utc2tai(day.utc, o_d.get_dat(day.utc));
+      days.push_back(day);
+
+      // LOOP (指定秒間隔; 同じ TLE・DAT の区間毎に分割)
+      while (k < k_e) {
+        j      = (k * n_sec - c * kNsecD) * 1.0e-9;
+        utc_wk = ts_add(day.utc, j);
+        ut1_wk = ts_add(day.ut1, j);
+        // DAT は次のうるう秒適用日時を越えた時のみ取得し直す
+        if (utc_wk.tv_sec >= dat_nxt.tv_sec) {
+          dat     = o_d.get_dat(utc_wk);
+          dat_nxt = o_d.next_leap(utc_wk);
+        }
+
+        // TLE 取得
+        if (o_t != nullptr) {
+          run.tle = &o_t->get_tle(ut1_wk);
+          tle_nxt = o_t->next_epoch(ut1_wk);
+        }
+
+        // 区間の終端（TLE 切り替え・うるう秒適用の直前まで; 最大 kBatch 件）
+        k_r = k + 1;
+        while (k_r < k_e && k_r - k < kBatch) {
+          j_r = (k_r * n_sec - c * kNsecD) * 1.0e-9;
+          if (ts_add(day.ut1, j_r).tv_sec >= tle_nxt.tv_sec ||
+              ts_add(day.utc, j_r).tv_sec >= dat_nxt.tv_sec) { break; }
+          ++k_r;
+        }
+        run.day = days.size() - 1;
+        run.k   = k;
+        run.n   = k_r - k;
+        run.ut1 = ut1_wk;
+        run.tai = utc2tai(utc_wk, dat);
+        runs.push_back(run);
+        k = k_r;
+      }
+    }
+  } catch (...) {
+    throw;
+  }
+}
+
+/*
+ * @brief       一括計算（等間隔）
+ *              * 指定 UT1 から指定秒間隔で指定件数分の位置・速度を計算し、
+ *                構造体配列に格納する
+ *              * SGP4, TEME -> ECEF 回転, ECEF -> BLH 変換, 速さの計算を
+ *                それぞれ全件まとめて行う
+ *              * 衛星情報(TLE)・DAT は全件で同じものとする
+ *                (Blh の極運動・LOD も同様)
+ *              * SGP4 は Kepler 方程式の逐次解法で計算する(Satellite::kep_seq)
+ *                (前回の解は区間の先頭で捨て、区間の終わりで逐次解法を止める;
+ *                 衛星情報はキャッシュされ他の区間と共有されるため)
+ *              * 計算後の Satellite::error は、いずれかの計算時刻(節点)で
+ *                SGP4 がエラーとなれば最初のエラーコード（0 以外なら区間の
+ *                結果は使えない; 途中のエラーを後の計算時刻で上書きしない）
+ *
+ * @param[ref]  SGP4 (Sgp4)
+ * @param[ref]  衛星情報 (Satellite)
+ * @param[ref]  BLH 変換 (Blh)
+ * @param[in]   UT1(計算開始) (timespec)
+ * @param[in]   TAI(計算開始) (timespec)
+ * @param[in]   計算間隔(秒) (double)
+ * @param[in]   件数 (unsigned int)
+ * @param[out]  軌道 (Trajectory)
+ * @param[in]   Hermite 補間の設定 (Interp; 既定値: 補間しない)
+ */
+void propagate_batch(
+    Sgp4& o_s, Satellite& sat, Blh& o_b,
+    struct timespec ut1, struct timespec tai, double step, unsigned int n,
+    Trajectory& trj, const Interp& ip) {
+  unsigned int  i;
+  unsigned int  m;     // 節点の間隔(計算回数)
+  unsigned int  n_nd;  // 節点数
+  unsigned long kn;    // Kepler 方程式を解いた回数(計算前)
+  unsigned long ki;    // Kepler 方程式の反復回数(計算前)
+  int           err;   // エラーコード(最初のもの)
+  PvTeme        teme;
+  Trajectory*   p = &trj;
+
+  try {
+    trj.resize(n);
+    for (i = 0; i < n; ++i) { trj.t[i] = i * step; }
+    m    = interp_stride(o_s, sat, step, ip);
+    n_nd = (n == 0) ? 0 : (n + m - 2) / m + 1;
+    sat.kep_seq = true;
+    sat.kep_off = 0.0;
+    kn  = sat.kep_n;
+    ki  = sat.kep_itr;
+    err = 0;
+
+    // SGP4（TEME 位置・速度; 補間時は節点(m 件毎と末尾)のみ）
+    {
+      ProfTimer pt(Stage::kSgp4, n_nd);
+      for (i = 0; i < n; i = (i + 1 == n || i + m < n) ? i + m : n - 1) {
+        teme = o_s.propagate(sat, ts_add(ut1, trj.t[i]));
+        if (err == 0) { err = sat.error; }
+        trj.x[i]  = teme.r.x;
+        trj.y[i]  = teme.r.y;
+        trj.z[i]  = teme.r.z;
+        trj.vx[i] = teme.v.x;
+        trj.vy[i] = teme.v.y;
+        trj.vz[i] = teme.v.z;
+      }
+    }
+    sat.kep_seq = false;
+    sat.error   = err;
+    if (Prof::enabled()) { Prof::add_kepler(sat.kep_n - kn, sat.kep_itr - ki); }
+    if (m > 1) { interp_hermite(m, trj); }
+
+    transform_batch(o_b, ut1, tai, step, n, &p, 1);
+  } catch (...) {
+    throw;
+  }
+}
+
+/*
+ * @brief       Hermite 補間の節点の間隔(計算回数)
+ *              * 3次 Hermite 補間の位置の誤差は h^4 / 384 * max|r の4階微分|
+ *                以下（h: 節点の間隔）。4階微分の大きさは2体問題の近地点
+ *                での値 a (1 + e) w_p^4（w_p: 近地点の角速度）を目安とし、
+ *                誤差が上限の kHermSafe 倍に収まる h を求める
+ *              * 2体問題の見積もりは J2・抗力などの摂動を含まず、実際の誤差は
+ *                見積もりをわずかに越える（ISS の実測で 0.5% 程度）ため、
+ *                上限に余裕を持たせる（誤差は h^4 に比例するため、h は
+ *                kHermSafe^(1/4) 倍(約 0.84 倍)になる）
+ *              * 上限は位置のみ（補間多項式の微分である速度の誤差は上限の
+ *                対象外）
+ *              * h は設定の上限以下とし、計算間隔の整数倍に切り捨てる
+ *
+ * @param[in]   SGP4 (Sgp4)
+ * @param[in]   衛星情報 (Satellite; 初期化済み)
+ * @param[in]   計算間隔(秒) (double)
+ * @param[in]   Hermite 補間の設定 (Interp)
+ * @return      節点の間隔(計算回数; 1 なら補間しない) (unsigned int)
+ */
+unsigned int interp_stride(
+    const Sgp4& o_s, const Satellite& sat, double step, const Interp& ip) {
+  double n_s;  // 平均運動(rad/s)
+  double a;    // 軌道長半径(km)
+  double e;    // 離心率
+  double w_p;  // 近地点の角速度(rad/s)
+  double h;    // 節点の間隔(秒)
+
+  try {
+    if (ip.step <= step || ip.tol <= 0.0 || sat.no <= 0.0) { return 1; }
+    n_s = sat.no / 60.0;
+    a   = cbrt(o_s.get_const().mu / (n_s * n_s));
+    e   = std::min(std::max(sat.ecco, 0.0), kEccMax);
+    w_p = n_s * sqrt(1.0 + e) / ((1.0 - e) * sqrt(1.0 - e));
+    h   = pow(384.0 * ip.tol * kHermSafe / (a * (1.0 + e) * pow(w_p, 4)),
+              0.25);
+    h   = std::min(h, ip.step);
+    if (h < 2.0 * step) { return 1; }
+    return static_cast<unsigned int>(
+        std::min(floor(h / step), static_cast<double>(kBatch)));
+  } catch (...) {
+    throw;
+  }
+}
+
+/*
+ * @brief       一括計算（間引き）
+ *              * 指定 UT1 から指定秒間隔の計算時刻のうち、前後の残した
+ *                計算時刻からの線形補間(緯度・経度・高度)で誤差が上限を越える
+ *                ものだけを残す（出力の件数を減らす）
+ *              * kSeed 秒毎と末尾の計算時刻を残して初期の分割とし、それぞれ
+ *                再帰的に細分化する（必要な計算時刻だけ SGP4 で計算する）
+ *              * 日付変更線をまたぐ前後の計算時刻は必ず残す（地図上で
+ *                線分が日付変更線をまたがないように）
+ *              * 結果は残した計算時刻だけを先頭から詰めて格納し、計算回
+ *                (区間の先頭から)を k に格納する
+ *              * SGP4 は Kepler 方程式の逐次解法で計算する(Satellite::kep_seq)
+ *                (前回の解は区間の先頭で捨て、区間の終わりで逐次解法を止める;
+ *                 衛星情報はキャッシュされ他の区間と共有されるため)
+ *
+ * @param[ref]  SGP4 (Sgp4)
+ * @param[ref]  衛星情報 (Satellite)
+ * @param[ref]  BLH 変換 (Blh)
+ * @param[in]   UT1(計算開始) (timespec)
+ * @param[in]   TAI(計算開始) (timespec)
+ * @param[in]   計算間隔(秒) (double)
+ * @param[in]   件数(間引く前) (unsigned int)
+ * @param[in]   誤差の上限(km) (double)
+ * @param[out]  軌道 (Trajectory)
+ */
+void propagate_adaptive(
+    Sgp4& o_s, Satellite& sat, Blh& o_b,
+    struct timespec ut1, struct timespec tai, double step, unsigned int n,
+    double tol, Trajectory& trj) {
+  unsigned int      i;
+  unsigned int      a;    // 残した計算時刻(初期の分割の始端)
+  unsigned int      m;    // 初期の分割の間隔(計算回数)
+  unsigned int      c;    // 残した件数
+  unsigned long     kn;   // Kepler 方程式を解いた回数(計算前)
+  unsigned long     ki;   // Kepler 方程式の反復回数(計算前)
+  std::vector<char> st;   // 状態一覧(0: 未計算, 1: 計算済み, 2: 残す)
+
+  try {
+    trj.resize(n);
+    if (n == 0) { return; }
+    for (i = 0; i < n; ++i) { trj.t[i] = i * step; }
+    st.assign(n, 0);
+    m = std::max(1u, static_cast<unsigned int>(kSeed / step));
+    sat.kep_seq = true;
+    sat.kep_off = 0.0;
+    kn = sat.kep_n;
+    ki = sat.kep_itr;
+
+    // 初期の分割・細分化
+    {
+      ProfTimer pt(Stage::kSgp4, n);
+      eval_point(o_s, sat, o_b, ut1, tai, 0, trj);
+      st[0] = 2;
+      for (a = 0; a + 1 < n; a = i) {
+        i = std::min(a + m, n - 1);
+        eval_point(o_s, sat, o_b, ut1, tai, i, trj);
+        st[i] = 2;
+        refine(o_s, sat, o_b, ut1, tai, tol, a, i, trj, st);
+      }
+    }
+    sat.kep_seq = false;
+    if (Prof::enabled()) { Prof::add_kepler(sat.kep_n - kn, sat.kep_itr - ki); }
+
+    // 残した計算時刻を先頭から詰める
+    for (i = 0, c = 0; i < n; ++i) {
+      if (st[i] != 2) { continue; }
+      trj.t[c]     = trj.t[i];
+      trj.x[c]     = trj.x[i];
+      trj.y[c]     = trj.y[i];
+      trj.z[c]     = trj.z[i];
+      trj.vx[c]    = trj.vx[i];
+      trj.vy[c]    = trj.vy[i];
+      trj.vz[c]    = trj.vz[i];
+      trj.xe[c]    = trj.xe[i];
+      trj.ye[c]    = trj.ye[i];
+      trj.ze[c]    = trj.ze[i];
+      trj.vxe[c]   = trj.vxe[i];
+      trj.vye[c]   = trj.vye[i];
+      trj.vze[c]   = trj.vze[i];
+      trj.lat[c]   = trj.lat[i];
+      trj.lon[c]   = trj.lon[i];
+      trj.h[c]     = trj.h[i];
+      trj.speed[c] = trj.speed[i];
+      trj.k.push_back(i);
+      ++c;
+    }
+    trj.n = c;
+  } catch (...) {
+    throw;
+  }
+}
+
+/*
+ * @brief       一括計算（等間隔; 近地球の衛星 kLanes 個を同時に）
+ *              * propagate_batch の SGP4 部分を Sgp4Simd で衛星毎のレーンに
+ *                分けて行う（TEME -> BLH は全衛星分まとめて行う）
+ *              * 計算時刻は全衛星で同じ（元期からの経過時間は衛星毎）
+ *              * エラーコードは、いずれかの計算時刻で SGP4 がエラーとなれば
+ *                最初のもの（propagate_batch の Satellite::error と同様）
+ *
+ * @param[ref]  SGP4(一括) (Sgp4Simd)
+ * @param[in]   軌道要素 (NearLanes; 有効なレーン数は NearLanes::n)
+ * @param[ref]  BLH 変換 (Blh)
+ * @param[in]   UT1(計算開始) (timespec)
+ * @param[in]   TAI(計算開始) (timespec)
+ * @param[in]   計算間隔(秒) (double)
+ * @param[in]   件数 (unsigned int)
+ * @param[out]  軌道一覧 (Trajectory*; NearLanes::n 個)
+ * @param[out]  エラーコード一覧 (int; NearLanes::n 個)
+ */
+void propagate_lanes(
+    Sgp4Simd& o_v, const NearLanes& nl, Blh& o_b,
+    struct timespec ut1, struct timespec tai, double step, unsigned int n,
+    Trajectory* const* trjs, int* err) {
+  unsigned int i;
+  unsigned int l;
+  JulianDay    jd;
+  double       ts[kLanes];  // 元期からの経過時間(分)
+  PvLanes      pv;
+
+  try {
+    for (l = 0; l < nl.n; ++l) {
+      trjs[l]->resize(n);
+      err[l] = 0;
+    }
+
+    // SGP4（TEME 位置・速度）
+    {
+      ProfTimer pt(Stage::kSgp4, static_cast<unsigned long>(n) * nl.n);
+      for (i = 0; i < n; ++i) {
+        jd = ts2jd(ts_add(ut1, i * step));
+        for (l = 0; l < kLanes; ++l) {
+          ts[l] = ((jd.jd - nl.jdsatepoch[l]) + jd.fr) * kMinD;
+        }
+        o_v.propagate(nl, ts, pv);
+        for (l = 0; l < nl.n; ++l) {
+          trjs[l]->t[i]  = i * step;
+          trjs[l]->x[i]  = pv.rx[l];
+          trjs[l]->y[i]  = pv.ry[l];
+          trjs[l]->z[i]  = pv.rz[l];
+          trjs[l]->vx[i] = pv.vx[l];
+          trjs[l]->vy[i] = pv.vy[l];
+          trjs[l]->vz[i] = pv.vz[l];
+          if (err[l] == 0) { err[l] = pv.err[l]; }
+        }
+      }
+    }
+
+    transform_batch(o_b, ut1, tai, step, n, trjs, nl.n);
+  } catch (...) {
+    throw;
+  }
+}
+
+/*
+ * @brief       一括計算の座標変換（TEME -> ECEF(位置・速度) -> BLH, 速さ）
+ *              * 計算時刻が同じ軌道(衛星)を複数まとめて変換する
+ *                (TEME -> ECEF の回転行列・地球自転項の行列は計算時刻毎に
+ *                 1回だけ求め、位置・速度を同じループで変換する)
+ *              * 回転行列は等間隔の計算時刻として逐次生成する
+ *                (Blh::start_rw / next_rw)
+ *              * ECEF -> BLH は軌道毎に配列をまとめて閉形式で変換する
+ *                (ecef2blh_batch)
+ *              * 各軌道の t (i * 計算間隔), x .. vz は設定済みとする
+ *
+ * @param[ref]  BLH 変換 (Blh)
+ * @param[in]   UT1(計算開始) (timespec)
+ * @param[in]   TAI(計算開始) (timespec)
+ * @param[in]   計算間隔(秒) (double)
+ * @param[in]   件数 (unsigned int)
+ * @param[ref]  軌道一覧 (Trajectory*)
+ * @param[in]   軌道数 (unsigned int)
+ */
+void transform_batch(
+    Blh& o_b, struct timespec ut1, struct timespec tai, double step,
+    unsigned int n, Trajectory* const* trjs, unsigned int m) {
+  unsigned int i;
+  unsigned int j;
+  Mtx3         mtx_r;
+  Mtx3         mtx_w;
+
+  try {
+    if (m == 0) { return; }
+
+    // TEME -> ECEF -> BLH
+    {
+      ProfTimer pt(Stage::kBlh, static_cast<unsigned long>(n) * m);
+      o_b.start_rw(ut1, tai, step);
+      for (i = 0; i < n; ++i) {
+        o_b.next_rw(mtx_r, mtx_w);
+        for (j = 0; j < m; ++j) { rotate(mtx_r, mtx_w, i, *trjs[j]); }
+      }
+      for (j = 0; j < m; ++j) {
+        Trajectory& trj = *trjs[j];
+        ecef2blh_batch(n, trj.xe.data(), trj.ye.data(), trj.ze.data(),
+                       trj.lat.data(), trj.lon.data(), trj.h.data());
+      }
+    }
+
+    // 速さ（速度は BLH 変換しない）
+    for (j = 0; j < m; ++j) {
+      Trajectory& trj = *trjs[j];
+      for (i = 0; i < n; ++i) {
+        trj.speed[i] = sqrt(trj.vx[i] * trj.vx[i] + trj.vy[i] * trj.vy[i]
+                     + trj.vz[i] * trj.vz[i]);
+      }
+    }
+  } catch (...) {
+    throw;
+  }
+}
+
+/*
+ * @brief       一括計算結果の文字列化
+ *              * 区間内のレコードを ",\n" 区切りで連結する
+ *                (Json::write_recs で書き込む)
+ *              * 間引き時は軌道に残した計算時刻のみ
+ *              * 対地速度を出力する場合は ECEF 速度・対地速度・方位を
+ *                レコードに加える
+ *              * 複数スレッドから呼び出し可
+ *
+ * @param[in]   日データ (BatchDay)
+ * @param[in]   区間 (BatchRun)
+ * @param[in]   軌道 (Trajectory)
+ * @param[in]   計算間隔(ナノ秒) (long long)
+ * @param[out]  文字列 (string)
+ * @param[in]   対地速度を出力するか (bool; 既定値: false)
+ */
+void format_batch(
+    const BatchDay& d, const BatchRun& r, const Trajectory& trj,
+    long long n_sec, std::string& txt, bool gnd) {
+  struct timespec jst;    // JST
+  struct timespec utc;    // UTC
+  double          j;      // 1日分の先頭からの経過秒
+  unsigned int    i;      // loop index
+  size_t          p = 0;  // 書き込み位置
+  PvGnd           g;      // 対地速度
+
+  try {
+    ProfTimer pt(Stage::kJson, trj.n);
+    txt.resize(trj.n * (kRecMax + 2));
+    for (i = 0; i < trj.n; ++i) {
+      j   = ((r.k + (trj.k.empty() ? i : trj.k[i])) * n_sec - d.c * kNsecD)
+          * 1.0e-9;
+      jst = ts_add(d.jst, j);
+      utc = ts_add(d.utc, j);
+      if (i > 0) {
+        txt[p++] = ',';
+        txt[p++] = '\n';
+      }
+      if (gnd) {
+        g = Blh::ecef2gnd({trj.lat[i], trj.lon[i], trj.h[i]},
+                          {trj.vxe[i], trj.vye[i], trj.vze[i]});
+      }
+      p += Json::put_rec(&txt[p], jst, utc,
+                         {{trj.lat[i], trj.lon[i], trj.h[i]}, trj.speed[i]},
+                         gnd ? &g : nullptr);
+    }
+    txt.resize(p);
+  } catch (...) {
+    throw;
+  }
+}
+
+/*
+ * @brief       一括計算（区間一覧; 並列）
+ *              * 区間一覧の各区間を一括計算して文字列化し、区間の順に出力
+ *                処理へ渡す
+ *              * スレッド数が2以上なら、計算・文字列化をワーカースレッドで
+ *                並列に行う（出力処理は呼び出し元スレッドで区間の順に行う）
+ *              * Sgp4(衛星情報のキャッシュ)・Blh・軌道はワーカー毎に持つ
+ *                ため、結果はスレッド数によらず同一
+ *              * 計算済み未出力の区間は「スレッド数 * kWindow」件まで
+ *
+ * @param[in]   日データ一覧 (vector<BatchDay>)
+ * @param[in]   区間一覧 (vector<BatchRun>)
+ * @param[in]   計算間隔(秒) (double)
+ * @param[in]   スレッド数 (unsigned int)
+ * @param[in]   Hermite 補間の設定 (Interp)
+ * @param[in]   文字列化処理(ワーカースレッドで実行) (function)
+ * @param[in]   出力処理(呼び出し元スレッドで区間の順に実行) (function)
+ */
+void run_batches(
+    const std::vector<BatchDay>& days, const std::vector<BatchRun>& runs,
+    double step, unsigned int n_thr, const Interp& ip,
+    const std::function<
+        void(const BatchRun&, const Trajectory&, std::string&)>& fmt,
+    const std::function<void(const BatchRun&, const std::string&)>& out) {
+  size_t                   n_win;    // 計算済み未出力区間の上限
+  size_t                   nxt = 0;  // 次に計算する区間
+  size_t                   wrt = 0;  // 出力済み区間数
+  std::vector<char>        done;     // 計算済みか(区間毎)
+  std::vector<std::string> txts;     // 文字列(区間 % n_win 毎)
+  std::vector<std::thread> thrs;     // ワーカースレッド
+  std::exception_ptr       err;      // ワーカーで発生した例外
+  std::mutex               mtx;
+  std::condition_variable  cv;
+  size_t                   i;
+
+  // 1区間の計算・文字列化
+  auto calc = [&](Sgp4& o_s, Trajectory& trj, const BatchRun& r,
+                  std::string& txt) {
+    const BatchDay& d = days[r.day];
+    Blh o_b(d.ut1, d.tai, d.pm_x, d.pm_y, d.lod);
+    if (ip.adp > 0.0) {
+      propagate_adaptive(o_s, o_s.get_sat(*r.tle), o_b, r.ut1, r.tai, step,
+                         r.n, ip.adp, trj);
+    } else {
+      propagate_batch(o_s, o_s.get_sat(*r.tle), o_b, r.ut1, r.tai, step, r.n,
+                      trj, ip);
+    }
+    fmt(r, trj, txt);
+  };
+
+  try {
+    // 単一スレッド
+    if (n_thr <= 1) {
+      Sgp4        o_s;
+      Trajectory  trj;
+      std::string txt;
+      for (const BatchRun& r : runs) {
+        calc(o_s, trj, r, txt);
+        out(r, txt);
+      }
+      return;
+    }
+
+    // ワーカースレッド
+    // * 出力待ちの区間が上限に達したら出力されるまで待つ
+    n_win = n_thr * kWindow;
+    done.assign(runs.size(), 0);
+    txts.resize(n_win);
+    for (i = 0; i < n_thr; ++i) {
+      thrs.emplace_back([&]() {
+        Sgp4       o_s;
+        Trajectory trj;
+        size_t     j;
+        while (true) {
+          {
+            std::unique_lock<std::mutex> lk(mtx);
+            cv.wait(lk, [&]() {
+              return nxt >= runs.size() || nxt < wrt + n_win || err;
+            });
+            if (nxt >= runs.size() || err) { return; }
+            j = nxt++;
+          }
+          try {
+            calc(o_s, trj, runs[j], txts[j % n_win]);
+          } catch (...) {
+            std::lock_guard<std::mutex> lk(mtx);
+            if (!err) { err = std::current_exception(); }
+          }
+          {
+            std::lock_guard<std::mutex> lk(mtx);
+            done[j] = 1;
+          }
+          cv.notify_all();
+        }
+      });
+    }
+
+    // 出力（区間の順）
+    for (i = 0; i < runs.size(); ++i) {
+      {
+        std::unique_lock<std::mutex> lk(mtx);
+        cv.wait(lk, [&]() { return done[i] || err; });
+        if (err) { break; }
+      }
+      try {
+        out(runs[i], txts[i % n_win]);
+      } catch (...) {
+        std::lock_guard<std::mutex> lk(mtx);
+        err = std::current_exception();
+        break;
+      }
+      {
+        std::lock_guard<std::mutex> lk(mtx);
+        wrt = i + 1;
+      }
+      cv.notify_all();
+    }
+    {
+      // 例外発生時は残りの区間を計算しない
+      std::lock_guard<std::mutex> lk(mtx);
+      nxt = runs.size();
+    }
+    cv.notify_all();
+    for (std::thread& t : thrs) { t.join(); }
+    if (err) { std::rethrow_exception(err); }
+  } catch (...) {
+    throw;
+  }
+}
+
+/*
+ * @brief       Hermite 補間の誤差計測
+ *              * 区間一覧の各区間を、補間あり・なし(全件 SGP4)の両方で
+ *                計算し、補間した計算時刻での差を集計する
+ *              * 単一スレッドで計算する（出力とは別に全件を計算し直す）
+ *
+ * @param[in]   日データ一覧 (vector<BatchDay>)
+ * @param[in]   区間一覧 (vector<BatchRun>)
+ * @param[in]   計算間隔(秒) (double)
+ * @param[in]   Hermite 補間の設定 (Interp)
+ * @param[out]  誤差 (InterpErr)
+ */
+void check_interp(
+    const std::vector<BatchDay>& days, const std::vector<BatchRun>& runs,
+    double step, const Interp& ip, InterpErr& er) {
+  Sgp4         o_s;
+  Trajectory   t_h;  // 補間あり
+  Trajectory   t_f;  // 補間なし
+  unsigned int m;    // 節点の間隔(計算回数)
+  unsigned int i;
+  double       d;    // 差
+  double       dx, dy, dz;
+
+  try {
+    er = InterpErr();
+    for (const BatchRun& r : runs) {
+      const BatchDay& day  = days[r.day];
+      Satellite&      sat  = o_s.get_sat(*r.tle);
+      Blh o_b(day.ut1, day.tai, day.pm_x, day.pm_y, day.lod);
+      m = interp_stride(o_s, sat, step, ip);
+      if (m <= 1) { continue; }
+      propagate_batch(o_s, sat, o_b, r.ut1, r.tai, step, r.n, t_h, ip);
+      propagate_batch(o_s, sat, o_b, r.ut1, r.tai, step, r.n, t_f);
+      for (i = 0; i < r.n; ++i) {
+        if (i % m == 0 || i == r.n - 1) { continue; }
+        ++er.n;
+        dx = t_h.x[i] - t_f.x[i];
+        dy = t_h.y[i] - t_f.y[i];
+        dz = t_h.z[i] - t_f.z[i];
+        d  = dx * dx + dy * dy + dz * dz;
+        er.r_sq += d;
+        er.r_max = std::max(er.r_max, sqrt(d));
+        dx = t_h.vx[i] - t_f.vx[i];
+        dy = t_h.vy[i] - t_f.vy[i];
+        dz = t_h.vz[i] - t_f.vz[i];
+        er.v_max = std::max(er.v_max, sqrt(dx * dx + dy * dy + dz * dz));
+        er.b_max = std::max(er.b_max, std::abs(t_h.lat[i] - t_f.lat[i]));
+        d = std::abs(t_h.lon[i] - t_f.lon[i]);
+        er.l_max = std::max(er.l_max, std::min(d, 360.0 - d));
+        er.h_max = std::max(er.h_max, std::abs(t_h.h[i] - t_f.h[i]));
+        er.s_max = std::max(er.s_max, std::abs(t_h.speed[i] - t_f.speed[i]));
+      }
+    }
+  } catch (...) {
+    throw;
+  }
+}
+
+/*
+ * @brief       間引きの誤差計測
+ *              * 区間一覧の各区間を、間引きあり・なし(全件 SGP4)の両方で
+ *                計算し、間引いた計算時刻での線形補間(緯度・経度・高度)の
+ *                誤差を集計する（r_max, r_sq, b_max, l_max, h_max のみ）
+ *              * 単一スレッドで計算する（出力とは別に全件を計算し直す）
+ *
+ * @param[in]   日データ一覧 (vector<BatchDay>)
+ * @param[in]   区間一覧 (vector<BatchRun>)
+ * @param[in]   計算間隔(秒) (double)
+ * @param[in]   補間・間引きの設定 (Interp)
+ * @param[out]  誤差 (InterpErr)
+ */
+void check_adaptive(
+    const std::vector<BatchDay>& days, const std::vector<BatchRun>& runs,
+    double step, const Interp& ip, InterpErr& er) {
+  Sgp4         o_s;
+  Trajectory   t_a;  // 間引きあり
+  Trajectory   t_f;  // 間引きなし
+  unsigned int i;
+  unsigned int j;    // 残した計算時刻(t_a の index; 終端)
+  double       d;    // 差
+  double       s;    // 区間内の位置(0 .. 1)
+
+  try {
+    er = InterpErr();
+    for (const BatchRun& r : runs) {
+      const BatchDay& day = days[r.day];
+      Satellite&      sat = o_s.get_sat(*r.tle);
+      Blh o_b(day.ut1, day.tai, day.pm_x, day.pm_y, day.lod);
+      propagate_adaptive(o_s, sat, o_b, r.ut1, r.tai, step, r.n, ip.adp, t_a);
+      propagate_batch(o_s, sat, o_b, r.ut1, r.tai, step, r.n, t_f);
+      for (i = 0, j = 0; i < r.n; ++i) {
+        while (j < t_a.n && t_a.k[j] < i) { ++j; }
+        if (j >= t_a.n || t_a.k[j] == i) { continue; }
+        ++er.n;
+        s = static_cast<double>(i - t_a.k[j - 1]) / (t_a.k[j] - t_a.k[j - 1]);
+        d = lin_err(t_a, j - 1, j, s, t_f.lat[i], t_f.lon[i], t_f.h[i]);
+        er.r_sq += d * d;
+        er.r_max = std::max(er.r_max, d);
+        er.b_max = std::max(er.b_max, std::abs(
+            t_f.lat[i] - (t_a.lat[j - 1] + s * (t_a.lat[j] - t_a.lat[j - 1]))));
+        er.l_max = std::max(er.l_max, std::abs(lon_diff(
+            t_f.lon[i],
+            t_a.lon[j - 1] + s * lon_diff(t_a.lon[j], t_a.lon[j - 1]))));
+        er.h_max = std::max(er.h_max, std::abs(
+            t_f.h[i] - (t_a.h[j - 1] + s * (t_a.h[j] - t_a.h[j - 1]))));
+      }
+    }
+  } catch (...) {
+    throw;
+  }
+}
+
+}  // namespace iss_sgp4_json
@@ -0,0 +1,133 @@
+#ifndef ISS_SGP4_JSON_BATCH_HPP_
+#define ISS_SGP4_JSON_BATCH_HPP_
+
+#include "blh.hpp"
+#include "dat.hpp"
+#include "eop.hpp"
+#include "json.hpp"
+#include "sgp4.hpp"
+#include "sgp4_simd.hpp"
+#include "time.hpp"
+#include "tle.hpp"
+
+#include <ctime>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace iss_sgp4_json {
+
+// 軌道（構造体配列(SoA)）
+// * 各配列の i 番目が i 番目の計算時刻の値
+struct Trajectory {
+  unsigned int        n = 0;  // 件数
+  std::vector<double> t;      // 計算開始からの経過秒
+  std::vector<double> x;      // 位置(TEME; x; km)
+  std::vector<double> y;      // 位置(TEME; y; km)
+  std::vector<double> z;      // 位置(TEME; z; km)
+  std::vector<double> vx;     // 速度(TEME; x; km/s)
+  std::vector<double> vy;     // 速度(TEME; y; km/s)
+  std::vector<double> vz;     // 速度(TEME; z; km/s)
+  std::vector<double> xe;     // 位置(ECEF; x; km)
+  std::vector<double> ye;     // 位置(ECEF; y; km)
+  std::vector<double> ze;     // 位置(ECEF; z; km)
+  std::vector<double> vxe;    // 速度(ECEF; x; km/s)
+  std::vector<double> vye;    // 速度(ECEF; y; km/s)
+  std::vector<double> vze;    // 速度(ECEF; z; km/s)
+  std::vector<double> lat;    // 緯度(°)
+  std::vector<double> lon;    // 経度(°)
+  std::vector<double> h;      // 高度(km)
+  std::vector<double> speed;  // 速さ(TEME; km/s)
+  std::vector<unsigned int> k;  // 計算回(区間の先頭から; 間引き時のみ)
+  void resize(unsigned int);  // 件数変更
+};
+
+// 一括計算の日データ
+// * EOP・極運動は1日分共通
+struct BatchDay {
+  long long       c;     // 日(計算開始から; 0 始まり)
+  struct timespec jst;   // JST(1日分の先頭)
+  struct timespec utc;   // UTC(1日分の先頭)
+  struct timespec ut1;   // UT1(1日分の先頭)
+  struct timespec tai;   // TAI(1日分の先頭)
+  double          pm_x;  // 極運動(x)
+  double          pm_y;  // 極運動(y)
+  double          lod;   // LOD
+};
+
+// 一括計算の区間
+// * 区間内では TLE・DAT が同じ
+struct BatchRun {
+  const std::vector<std::string>* tle;  // TLE
+  unsigned int    day;  // 日データの index
+  long long       k;    // 計算回(区間の先頭)
+  unsigned int    n;    // 件数
+  struct timespec ut1;  // UT1(区間の先頭)
+  struct timespec tai;  // TAI(区間の先頭)
+};
+
+// 補間・間引きの設定
+// * Hermite 補間: 粗い間隔(節点)でのみ SGP4 を計算し、その間の計算時刻の
+//   位置・速度を3次 Hermite 補間で求める
+// * 間引き: 前後の残した計算時刻からの線形補間(緯度・経度・高度)で誤差が
+//   上限に収まる計算時刻を出力しない
+struct Interp {
+  double step = 0.0;  // 節点の間隔の上限(秒; 0: 補間しない)
+  double tol  = 0.0;  // 位置の誤差の上限(km; 節点の間隔をこれに収まるよう縮める)
+  double adp  = 0.0;  // 間引きの誤差の上限(km; 0: 間引かない)
+};
+
+// 補間・間引きの誤差（全件 SGP4 との比較）
+struct InterpErr {
+  unsigned long n     = 0;    // 件数(補間した・間引いた計算時刻のみ)
+  double        r_max = 0.0;  // 位置(TEME)の差の最大(km)
+  double        r_sq  = 0.0;  // 位置(TEME)の差の2乗和(km^2)
+  double        v_max = 0.0;  // 速度(TEME)の差の最大(km/s)
+  double        b_max = 0.0;  // 緯度の差の最大(°)
+  double        l_max = 0.0;  // 経度の差の最大(°)
+  double        h_max = 0.0;  // 高度の差の最大(km)
+  double        s_max = 0.0;  // 速さの差の最大(km/s)
+};
+
+void plan_batches(
+    Eop&, Dat&, Tle*, struct timespec, long long, long long,
+    std::vector<BatchDay>&, std::vector<BatchRun>&);
+                                          // 一括計算の区間一覧作成
+void propagate_batch(
+    Sgp4&, Satellite&, Blh&, struct timespec, struct timespec,
+    double, unsigned int, Trajectory&, const Interp& = Interp());
+                                          // 一括計算（等間隔）
+unsigned int interp_stride(
+    const Sgp4&, const Satellite&, double, const Interp&);
+                                          // Hermite 補間の節点の間隔(計算回数)
+void propagate_adaptive(
+    Sgp4&, Satellite&, Blh&, struct timespec, struct timespec,
+    double, unsigned int, double, Trajectory&);
+                                          // 一括計算（間引き）
+void propagate_lanes(
+    Sgp4Simd&, const NearLanes&, Blh&, struct timespec, struct timespec,
+    double, unsigned int, Trajectory* const*, int*);
+                                          // 一括計算（等間隔; 近地球 kLanes 衛星）
+void transform_batch(
+    Blh&, struct timespec, struct timespec, double, unsigned int,
+    Trajectory* const*, unsigned int);    // 一括計算の座標変換
+void format_batch(
+    const BatchDay&, const BatchRun&, const Trajectory&, long long,
+    std::string&, bool = false);          // 一括計算結果の文字列化
+void run_batches(
+    const std::vector<BatchDay>&, const std::vector<BatchRun>&,
+    double, unsigned int, const Interp&,
+    const std::function<
+        void(const BatchRun&, const Trajectory&, std::string&)>&,
+    const std::function<void(const BatchRun&, const std::string&)>&);
+                                          // 一括計算（区間一覧; 並列）
+void check_interp(
+    const std::vector<BatchDay>&, const std::vector<BatchRun>&,
+    double, const Interp&, InterpErr&);   // Hermite 補間の誤差計測
+void check_adaptive(
+    const std::vector<BatchDay>&, const std::vector<BatchRun>&,
+    double, const Interp&, InterpErr&);   // 間引きの誤差計測
+
+}  // namespace iss_sgp4_json
+
+#endif
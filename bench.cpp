@@ -0,0 +1,432 @@
+/***********************************************************
+  主要処理のマイクロベンチマーク
+  : 処理毎にウォームアップ後、指定回数繰り返して 1回あたりの所要時間
+    (ナノ秒)の統計値(最小・中央値・平均・標準偏差・最大)を出力
+
+  ---
+  引数 : [オプション]
+         オプション:
+           -c, --csv          CSV 形式で出力(既定: JSON 形式)
+           -r, --reps REPS    繰り返し回数(既定値: 15)
+           -h, --help         使用方法の表示
+  ---
+  MEMO:
+    * tle.txt, eop.txt を実行ディレクトリから読み込む
+    * 結果は標準出力へ書き込む(コミット間の比較用)
+    * キャッシュミス(LLC)回数は perf_event_open で計測する
+      (計測できない環境では null(CSV では空欄))
+***********************************************************/
+#include "blh.hpp"
+#include "blh_simd.hpp"
+#include "eop.hpp"
+#include "ephem.hpp"
+#include "sgp4.hpp"
+#include "sgp4_simd.hpp"
+#include "time.hpp"
+#include "tle.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>   // for EXIT_XXXX
+#include <cstring>
+#include <getopt.h>
+#include <iomanip>
+#include <iostream>
+#include <linux/perf_event.h>
+#include <string>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <vector>
+
+namespace iss_sgp4_json {
+
+static constexpr unsigned int kReps = 15;  // 繰り返し回数(既定値)
+static constexpr unsigned int kWarm = 3;   // ウォームアップ回数
+static constexpr unsigned int kNCat = 20000;  // 大規模カタログの衛星数
+static constexpr unsigned int kDeep = 50;     // 大規模カタログの深宇宙の割合(1/N)
+static constexpr unsigned int kNBlh = 1024;   // BLH 一括変換の点数
+// 近地球(ISS)
+static const std::vector<std::string> kTleNear = {
+  "1 25544U 98067A   21153.43750692 -.00014500  00000-0 -26299-3 0    15",
+  "2 25544  51.6443  55.6868 0003510  52.1891 292.3111 15.48958837    16"
+};
+// 深宇宙(Molniya; 12時間共鳴)
+static const std::vector<std::string> kTleDeep = {
+  "1 08195U 75081A   06176.33215444  .00000099  00000-0  11873-3 0   813",
+  "2 08195  64.1586 279.0717 6877146 264.7651  20.2257  2.00491383225656"
+};
+
+// ベンチマーク結果構造体(1回あたりのナノ秒)
+struct BenchRes {
+  std::string   name;  // 処理名
+  unsigned long ops;   // 1繰り返しあたりの実行回数
+  unsigned int  reps;  // 繰り返し回数
+  double        min;   // 最小
+  double        p50;   // 中央値
+  double        mean;  // 平均
+  double        sd;    // 標準偏差
+  double        max;   // 最大
+  double        miss;  // キャッシュミス(LLC)回数の平均(負なら計測不可)
+};
+
+static int fd_miss = -1;  // キャッシュミス(LLC)カウンタ
+
+/*
+ * @brief      キャッシュミス(LLC)カウンタ open
+ *             * 計測できない環境(権限・仮想環境等)では何もしない
+ */
+static void open_miss() {
+  struct perf_event_attr a;
+
+  std::memset(&a, 0, sizeof(a));
+  a.size           = sizeof(a);
+  a.type           = PERF_TYPE_HARDWARE;
+  a.config         = PERF_COUNT_HW_CACHE_MISSES;
+  a.exclude_kernel = 1;
+  a.exclude_hv     = 1;
+  fd_miss = syscall(SYS_perf_event_open, &a, 0, -1, -1, 0);
+}
+
+/*
+ * @brief      キャッシュミス(LLC)回数の読み込み
+ *
+ * @return     回数(計測不可なら 0) (uint64_t)
+ */
+static uint64_t read_miss() {
+  uint64_t v = 0;
+
+  if (fd_miss < 0 || read(fd_miss, &v, sizeof(v)) != sizeof(v)) { return 0; }
+  return v;
+}
+
+static volatile double sink;  // 最適化による処理の除去防止
+
+/*
+ * @brief      計測
+ *             * ウォームアップ後、ops 回の実行を reps 回繰り返して計測する
+ *
+ * @param[in]  処理名 (const char*)
+ * @param[in]  1繰り返しあたりの実行回数 (unsigned long)
+ * @param[in]  繰り返し回数 (unsigned int)
+ * @param[in]  処理(引数: 実行回; 戻り値: 処理結果) (F)
+ * @return     結果 (BenchRes)
+ */
+template <class F>
+static BenchRes run(
+    const char* name, unsigned long ops, unsigned int reps, F f) {
+  std::vector<double> v;  // 1回あたりの所要時間(ナノ秒)
+  double              s;  // 処理結果の合計
+  double              m;  // キャッシュミス回数の合計
+  uint64_t            m_s;
+  unsigned int        r;  // loop index(繰り返し)
+  unsigned long       i;  // loop index(実行回)
+  BenchRes            res;
+  std::chrono::steady_clock::time_point t_s;
+
+  m = 0.0;
+  for (r = 0; r < kWarm + reps; ++r) {
+    s   = 0.0;
+    m_s = read_miss();
+    t_s = std::chrono::steady_clock::now();
+    for (i = 0; i < ops; ++i) { s += f(i); }
+    if (r >= kWarm) {
+      v.push_back(std::chrono::duration<double, std::nano>(
+          std::chrono::steady_clock::now() - t_s).count() / ops);
+      m += read_miss() - m_s;
+    }
+    sink = s;
+  }
+  std::sort(v.begin(), v.end());
+  res.name = name;
+  res.ops  = ops;
+  res.reps = reps;
+  res.min  = v.front();
+  res.p50  = v[(v.size() - 1) / 2];
+  res.max  = v.back();
+  res.mean = 0.0;
+  for (double t : v) { res.mean += t; }
+  res.mean /= v.size();
+  res.sd = 0.0;
+  for (double t : v) { res.sd += (t - res.mean) * (t - res.mean); }
+  res.sd = std::sqrt(res.sd / v.size());
+  res.miss = fd_miss < 0 ? -1.0 : m / reps / ops;
+
+  return res;
+}
+
+/*
+ * @brief      結果出力(JSON)
+ *
+ * @param[in]  結果一覧 (vector<BenchRes>)
+ */
+static void put_json(const std::vector<BenchRes>& rs) {
+  unsigned int i;
+
+  std::cout << std::fixed << std::setprecision(3)
+            << "{\n  \"unit\": \"ns/op\",\n  \"results\": [\n";
+  for (i = 0; i < rs.size(); ++i) {
+    std::cout << "    {\"name\": \"" << rs[i].name << "\""
+              << ", \"ops\": "  << rs[i].ops
+              << ", \"reps\": " << rs[i].reps
+              << ", \"min\": "  << rs[i].min
+              << ", \"p50\": "  << rs[i].p50
+              << ", \"mean\": " << rs[i].mean
+              << ", \"sd\": "   << rs[i].sd
+              << ", \"max\": "  << rs[i].max
+              << ", \"llc_miss\": ";
+    if (rs[i].miss < 0.0) {
+      std::cout << "null";
+    } else {
+      std::cout << rs[i].miss;
+    }
+    std::cout << "}"
+              << (i + 1 < rs.size() ? ",\n" : "\n");
+  }
+  std::cout << "  ]\n}" << std::endl;
+}
+
+/*
+ * @brief      結果出力(CSV)
+ *
+ * @param[in]  結果一覧 (vector<BenchRes>)
+ */
+static void put_csv(const std::vector<BenchRes>& rs) {
+  std::cout << std::fixed << std::setprecision(3)
+            << "name,ops,reps,min_ns,p50_ns,mean_ns,sd_ns,max_ns,llc_miss\n";
+  for (const BenchRes& r : rs) {
+    std::cout << r.name << "," << r.ops << "," << r.reps << ","
+              << r.min << "," << r.p50 << "," << r.mean << ","
+              << r.sd << "," << r.max << ",";
+    if (r.miss >= 0.0) { std::cout << r.miss; }
+    std::cout << "\n";
+  }
+  std::cout << std::flush;
+}
+
+/*
+ * @brief      使用方法の表示
+ *
+ * @param[in]  プログラム名 (const char*)
+ */
+static void usage(const char* prog) {
+  std::cout << "Usage: " << prog << " [OPTION]...\n"
+            << "  -c, --csv          output CSV (default: JSON)\n"
+            << "  -r, --reps REPS    repetitions per kernel (default: 15)\n"
+            << "  -h, --help         show this help" << std::endl;
+}
+
+}  // namespace iss_sgp4_json
+
+int main(int argc, char* argv[]) {
+  namespace ns = iss_sgp4_json;
+  static const struct option kLongOpts[] = {
+    {"csv",  no_argument,       nullptr, 'c'},
+    {"reps", required_argument, nullptr, 'r'},
+    {"help", no_argument,       nullptr, 'h'},
+    {nullptr, 0,                nullptr,  0 }
+  };
+  bool                      csv  = false;       // CSV 形式で出力
+  unsigned int              reps = ns::kReps;   // 繰り返し回数
+  int                       c;                  // オプション文字
+  char*                     e;                  // 数値変換の終端
+  struct timespec           ts;                 // 日時(基準)
+  struct timespec           ts_t;               // 日時(基準; TAI)
+  std::vector<ns::BenchRes> rs;                 // 結果一覧
+
+  try {
+    // オプション解析
+    while ((c = getopt_long(argc, argv, "cr:h", kLongOpts, nullptr)) != -1) {
+      switch (c) {
+        case 'c':
+          csv = true;
+          break;
+        case 'r':
+          reps = std::strtoul(optarg, &e, 10);
+          if (e == optarg || *e != '\0' || reps == 0) {
+            std::cerr << "[ERROR] Invalid reps: " << optarg << std::endl;
+            return EXIT_FAILURE;
+          }
+          break;
+        case 'h':
+          ns::usage(argv[0]);
+          return EXIT_SUCCESS;
+        default:
+          ns::usage(argv[0]);
+          return EXIT_FAILURE;
+      }
+    }
+
+    ns::Sgp4 o_s;
+    ns::Tle  o_t;
+    ns::Eop  o_e;
+    ns::Satellite sat_n = o_s.twoline2rv(ns::kTleNear);
+    ns::Satellite sat_d = o_s.twoline2rv(ns::kTleDeep);
+    ns::Satellite sat_s = sat_n;
+    sat_s.kep_seq = true;
+    ts = ns::dt2ts({2021, 6, 1, 0, 0, 0.0});
+    ts_t = ns::utc2tai(ts, 37);
+    ns::Blh o_b(ts, ts_t, 0.1, 0.4, 0.0);
+    ns::Mtx3 mtx_r;
+    ns::Mtx3 mtx_w;
+    ns::PvTeme teme = o_s.propagate(sat_n, 0.0);
+    // 特殊化した sgp4() の結果が同じであること（比較の前提）
+    for (const ns::Satellite* p : {&sat_n, &sat_d}) {
+      ns::Satellite sat_g = *p;
+      ns::Satellite sat_x = *p;
+      for (unsigned long i = 0; i < 20000; ++i) {
+        ns::PvTeme pv_g = o_s.propagate(sat_g, (i % 14400) * 0.1 - 100.0);
+        ns::PvTeme pv_x = o_s.propagate_spec(sat_x, (i % 14400) * 0.1 - 100.0);
+        if (std::memcmp(&pv_g, &pv_x, sizeof(pv_g)) != 0) {
+          std::cerr << "[ERROR] propagate_spec differs from propagate!"
+                    << std::endl;
+          return EXIT_FAILURE;
+        }
+      }
+    }
+    ns::Sgp4Simd o_v(o_s.get_const());
+    ns::NearLanes nl;
+    ns::PvLanes   pv;
+    const ns::Satellite* ss[ns::kLanes];
+    double ts_l[ns::kLanes];
+    std::fill(ss, ss + ns::kLanes, &sat_n);
+    o_v.load(ss, ns::kLanes, nl);
+    // 大規模カタログ（近地球・深宇宙の要素を少しずつずらしたもの）
+    std::vector<ns::Satellite> cat(ns::kNCat);
+    for (unsigned int i = 0; i < ns::kNCat; ++i) {
+      cat[i] = i % ns::kDeep == 0 ? sat_d : sat_n;
+      cat[i].mo    += i * 1.0e-3;
+      cat[i].nodeo += i * 1.0e-4;
+    }
+    // ECEF 座標（高度 400 km 前後の点を経度・緯度方向にずらしたもの）
+    std::vector<double> xe(ns::kNBlh), ye(ns::kNBlh), ze(ns::kNBlh);
+    std::vector<double> be(ns::kNBlh), le(ns::kNBlh), he(ns::kNBlh);
+    for (unsigned int i = 0; i < ns::kNBlh; ++i) {
+      xe[i] = 6778.0 * cos(i * 0.37) * cos(i * 0.011);
+      ye[i] = 6778.0 * sin(i * 0.37) * cos(i * 0.011);
+      ze[i] = 6778.0 * sin(i * 0.011);
+    }
+    // 暦（2日分）
+    ns::Ephem o_x;
+    o_x.fit(o_s, o_t, ts, 2.0 * 86400.0, 1.0e-3);
+    ns::open_miss();
+
+    // SGP4
+    rs.push_back(ns::run("twoline2rv", 2000, reps, [&](unsigned long i) {
+      return o_s.twoline2rv(i & 1 ? ns::kTleDeep : ns::kTleNear).no;
+    }));
+    rs.push_back(ns::run("propagate_near", 200000, reps, [&](unsigned long i) {
+      return o_s.propagate(sat_n, (i % 14400) * 0.1).r.x;
+    }));
+    // * 重力モデル・伝播方法で特殊化した sgp4()（propagate_near との比較用）
+    rs.push_back(ns::run("propagate_near_spec", 200000, reps,
+        [&](unsigned long i) {
+      return o_s.propagate_spec(sat_n, (i % 14400) * 0.1).r.x;
+    }));
+    // * Kepler 方程式の逐次解法(前回の解を初期値にする)
+    rs.push_back(ns::run("propagate_near_seq", 200000, reps,
+        [&](unsigned long i) {
+      return o_s.propagate(sat_s, (i % 14400) * 0.1).r.x;
+    }));
+    // * 1回 = kLanes 衛星分
+    rs.push_back(ns::run("propagate_near_simd", 25000, reps, [&](unsigned long i) {
+      std::fill(ts_l, ts_l + ns::kLanes, (i % 14400) * 0.1);
+      o_v.propagate(nl, ts_l, pv);
+      return pv.rx[0];
+    }));
+    // * 1回 = 1衛星（全衛星を順に同じ時刻で計算; 2% は深宇宙）
+    rs.push_back(ns::run("propagate_catalog", ns::kNCat, reps,
+        [&](unsigned long i) {
+      return o_s.propagate(cat[i], 10.0).r.x;
+    }));
+    rs.push_back(ns::run("propagate_catalog_spec", ns::kNCat, reps,
+        [&](unsigned long i) {
+      return o_s.propagate_spec(cat[i], 10.0).r.x;
+    }));
+    rs.push_back(ns::run("propagate_deep", 200000, reps, [&](unsigned long i) {
+      return o_s.propagate(sat_d, (i % 14400) * 0.1).r.x;
+    }));
+    rs.push_back(ns::run("propagate_deep_spec", 200000, reps,
+        [&](unsigned long i) {
+      return o_s.propagate_spec(sat_d, (i % 14400) * 0.1).r.x;
+    }));
+    // * 元期の前後10年の範囲をばらばらの順に計算（共鳴項の積分のチェックポイント）
+    rs.push_back(ns::run("propagate_deep_random", 20000, reps,
+        [&](unsigned long i) {
+      return o_s.propagate(
+          sat_d, ((i * 7919) % 20000 - 10000.0) * 525.6).r.x;
+    }));
+
+    // 座標変換
+    rs.push_back(ns::run("teme2blh", 200000, reps, [&](unsigned long i) {
+      teme.r.x += 1.0e-9;
+      return o_b.teme2blh(teme).r.b;
+    }));
+    rs.push_back(ns::run("teme2ecef", 200000, reps, [&](unsigned long i) {
+      teme.r.x += 1.0e-9;
+      return o_b.teme2ecef(teme).v.x;
+    }));
+    rs.push_back(ns::run("gen_mtx_rw", 200000, reps, [&](unsigned long i) {
+      o_b.set_time(ns::ts_add(ts, i * 1.0), ns::ts_add(ts_t, i * 1.0));
+      o_b.gen_mtx_rw(mtx_r, mtx_w);
+      return mtx_r[0][0];
+    }));
+    // * 1秒間隔の逐次生成（kRotChunk 回毎の直接計算を含む）
+    o_b.start_rw(ts, ts_t, 1.0);
+    rs.push_back(ns::run("next_rw", 1000000, reps, [&](unsigned long i) {
+      o_b.next_rw(mtx_r, mtx_w);
+      return mtx_r[0][0];
+    }));
+    rs.push_back(ns::run("ecef2blh", 200000, reps, [&](unsigned long i) {
+      unsigned int k = i % ns::kNBlh;
+      return o_b.ecef2blh({xe[k], ye[k], ze[k]}).b;
+    }));
+    // * 1回 = kNBlh 点分
+    rs.push_back(ns::run("ecef2blh_batch", 200, reps, [&](unsigned long i) {
+      xe[0] += 1.0e-9;
+      ns::ecef2blh_batch(ns::kNBlh, xe.data(), ye.data(), ze.data(),
+                         be.data(), le.data(), he.data());
+      return be[i % ns::kNBlh];
+    }));
+
+    // 暦
+    rs.push_back(ns::run("ephem_eval", 1000000, reps, [&](unsigned long i) {
+      return o_x.eval((i % 1728000) * 0.1).r.x;
+    }));
+
+    // 時刻
+    rs.push_back(ns::run("gen_time_str", 200000, reps, [&](unsigned long i) {
+      return static_cast<double>(
+          ns::gen_time_str(ns::ts_add(ts, i * 0.001)).size());
+    }));
+    rs.push_back(ns::run("ts_add", 1000000, reps, [&](unsigned long i) {
+      return static_cast<double>(ns::ts_add(ts, i * 0.001).tv_nsec);
+    }));
+    rs.push_back(ns::run("gc2jd", 1000000, reps, [&](unsigned long i) {
+      return ns::gc2jd({ts.tv_sec + static_cast<time_t>(i), 0});
+    }));
+
+    // データ検索
+    rs.push_back(ns::run("eop_lookup", 200000, reps, [&](unsigned long i) {
+      return o_e.get_eop(ns::mjd2ts(45000 + i % 14000)).dut1;
+    }));
+    rs.push_back(ns::run("tle_lookup", 1000000, reps, [&](unsigned long i) {
+      return static_cast<double>(
+          o_t.get_tle({ts.tv_sec + static_cast<time_t>(i % 172800), 0})[0]
+              .size());
+    }));
+
+    // 結果出力
+    if (csv) {
+      ns::put_csv(rs);
+    } else {
+      ns::put_json(rs);
+    }
+  } catch (...) {
+      std::cerr << "EXCEPTION!" << std::endl;
+      return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
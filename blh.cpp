@@ -9,6 +9,9 @@ static constexpr double       kPi    = atan(1.0) * 4.0;  // 円周率
 static constexpr double       kPi2   = kPi * 2.0;        // 円周率 * 2
 static constexpr double       kPi180 = kPi / 180.0;      // 円周率 / 180.0
 static constexpr double       kSecD  = 86400.0;          // Seconds per day
+// 回転行列の逐次生成
+static constexpr unsigned int kRotChunk = 1024;  // 直接計算し直す間隔(回)(上限)
+static constexpr unsigned int kRotNorm  = 64;    // cos, sin を正規化する間隔(回)
 // [ WGS84 座標パラメータ ]
 // a(地球楕円体長半径(赤道面平均半径))
 static constexpr double kA   = 6378137.0;
@@ -24,9 +27,10 @@ static constexpr double kEd2 = kE2 * kA * kA / (kB * kB);
 
 /*
  * @brief      コンストラクタ
+ *             * 極運動の回転行列はここで1回だけ生成する
  *
- * @param[in]  UTC       (timespec)
- * @param[in]  DUT1      (double)
+ * @param[in]  UT1       (timespec)
+ * @param[in]  TAI       (timespec)
  * @param[in]  極運動(x) (double)
  * @param[in]  極運動(y) (double)
  * @param[in]  LOD       (double)
@@ -34,60 +38,53 @@ static constexpr double kEd2 = kE2 * kA * kA / (kB * kB);
 Blh::Blh(
     struct timespec ut1, struct timespec tai,
     double pm_x, double pm_y, double lod) {
-  struct timespec tt;
-  double jd_tt;
   this->pm_x = pm_x;
   this->pm_y = pm_y;
   this->lod  = lod;
-  tt         = tai2tt(tai);
-  jd_ut1     = gc2jd(ut1);
-  jd_tt      = gc2jd(tt);
-  jcn_tt     = jd2jcn(jd_tt);
+  set_time(ut1, tai);
+  mtx_pm     = gen_mtx_rpm();
+  start_rw(ut1, tai, 0.0);
+}
+
+/*
+ * @brief      日時(UT1, TAI)の変更
+ *             * 極運動・LOD（及び極運動の回転行列）はそのまま
+ *
+ * @param[in]  UT1 (timespec)
+ * @param[in]  TAI (timespec)
+ */
+void Blh::set_time(struct timespec ut1, struct timespec tai) {
+  struct timespec tt;
+  JulianDay jd;
+
+  tt      = tai2tt(tai);
+  jd      = ts2jd(ut1);
+  jd_ut1  = jd.jd + jd.fr;
+  jcn_ut1 = ((jd.jd - kJ2k) + jd.fr) / kDayJc;
+  jd      = ts2jd(tt);
+  jcn_tt  = ((jd.jd - kJ2k) + jd.fr) / kDayJc;
 }
 
 /*
  * @brief   TEME -> BLH
+ *          * GMST 回転行列と極運動の回転行列を先に掛け合わせておき、
+ *            座標には1回だけ適用する
  *
  * @param   TEME (PvTeme)
  * @return  BLH  (PvBlh)
  */
-PvBlh Blh::teme2blh(PvTeme teme) {
-  double gmst;
-  double om;
-  double gmst_g;
-  std::vector<std::vector<double>> mtx_z( 3, std::vector<double>(3, 0.0));
-  std::vector<std::vector<double>> mtx_pm(3, std::vector<double>(3, 0.0));
-  Coord    r_pef  = {0.0, 0.0, 0.0};
-  //Coord    v_pef  = {0.0, 0.0, 0.0};
+PvBlh Blh::teme2blh(const PvTeme& teme) {
+  Mtx3     mtx_r;
   Coord    r_ecef = {0.0, 0.0, 0.0};
-  //Coord    v_wk   = {0.0, 0.0, 0.0};
-  Coord    om_e   = {0.0, 0.0, 0.0};
   CoordBlh blh_wk;
   PvBlh    blh;
 
   try {
-    // GMST（グリニッジ平均恒星時）計算
-    gmst   = calc_gmst();
-    // Ω（月の平均昇交点黄経）計算（IAU1980章動理論）
-    om     = calc_om();
-    // GMST に運動項を適用（1997年より新しい場合）
-    gmst_g = apply_kinematic(gmst, om);
-    // GMST 回転行列（z軸を中心とした回転）
-    mtx_z  = gen_mtx_rz(gmst_g);
-    // 極運動(Polar Motion)回転行列
-    mtx_pm = gen_mtx_rpm();
-    // PEF 座標の計算（GMST 回転行列の適用）
-    r_pef = apply_mtx(mtx_z, teme.r);
-    // ECEF 座標（位置）の計算（極運動(Polar Motion)の適用）
-    r_ecef = apply_mtx(mtx_pm, r_pef);
-    // Ω_earth値の計算
-    om_e = calc_om_e();
-    // PEF 座標（速度）の計算（GMST 回転行列の適用）
-    //v_pef = apply_mtx(mtx_z, teme.v);
-    //v_wk  = v_cross(om_e, r_pef);
-    //v_pef.x -= v_wk.x;
-    //v_pef.y -= v_wk.y;
-    //v_pef.z -= v_wk.z;
+    // TEME -> ECEF 回転行列（極運動(Polar Motion) * GMST）
+    mtx_r  = gen_mtx_r();
+    // ECEF 座標（位置）の計算
+    // * 速度(ECEF)は teme2ecef
+    r_ecef = apply_mtx(mtx_r, teme.r);
     // ECEF 座標 => BLH(Beta, Lambda, Height) 変換
     blh_wk = ecef2blh(r_ecef);
     blh.r.b = blh_wk.b;
@@ -104,10 +101,303 @@ PvBlh Blh::teme2blh(PvTeme teme) {
   return blh;
 }  // teme2blh
 
+/*
+ * @brief   TEME -> ECEF（位置・速度）
+ *          * r_pef = R_z * r_teme
+ *            v_pef = R_z * v_teme - ω_earth × r_pef
+ *            r_ecef = R_pm * r_pef, v_ecef = R_pm * v_pef
+ *            (R_z: GMST 回転行列, R_pm: 極運動の回転行列)
+ *          * 回転行列と地球自転項の行列(gen_mtx_rw)を先に求め、位置・速度
+ *            にそれぞれ適用する
+ *
+ * @param   TEME (PvTeme)
+ * @return  ECEF (PvEcef)
+ */
+PvEcef Blh::teme2ecef(const PvTeme& teme) {
+  Mtx3   mtx_r;
+  Mtx3   mtx_w;
+  Coord  v_wk;
+  PvEcef ecef;
+
+  try {
+    gen_mtx_rw(mtx_r, mtx_w);
+    ecef.r   = apply_mtx(mtx_r, teme.r);
+    ecef.v   = apply_mtx(mtx_r, teme.v);
+    v_wk     = apply_mtx(mtx_w, teme.r);
+    ecef.v.x -= v_wk.x;
+    ecef.v.y -= v_wk.y;
+    ecef.v.z -= v_wk.z;
+  } catch (...) {
+    throw;
+  }
+
+  return ecef;
+}
+
+/*
+ * @brief   TEME -> ECEF 回転行列生成
+ *          * 極運動の回転行列 * GMST 回転行列（現在の日時(UT1, TT)のもの）
+ *
+ * @param   <none>
+ * @return  回転行列(3x3) (Mtx3)
+ */
+Mtx3 Blh::gen_mtx_r() {
+  Mtx3 mtx_r;
+
+  try {
+    // 極運動(Polar Motion)回転行列と GMST 回転行列の積
+    mtx_r = mul_mtx(mtx_pm, gen_mtx_gmst());
+  } catch (...) {
+    throw;
+  }
+
+  return mtx_r;
+}
+
+/*
+ * @brief      TEME -> ECEF 回転行列・地球自転項の行列生成
+ *             * 回転行列は gen_mtx_r と同じ
+ *             * 地球自転項の行列は R_pm * [ω_earth ×] * R_z
+ *               (v_ecef = 回転行列 * v_teme - 地球自転項の行列 * r_teme)
+ *             * GMST 回転行列は1回だけ求める
+ *
+ * @param[out] 回転行列(3x3) (Mtx3)
+ * @param[out] 地球自転項の行列(3x3) (Mtx3)
+ */
+void Blh::gen_mtx_rw(Mtx3& mtx_r, Mtx3& mtx_w) {
+  try {
+    gen_mtx_rw_z(gen_mtx_gmst(), mtx_r, mtx_w);
+  } catch (...) {
+    throw;
+  }
+}
+
+/*
+ * @brief      回転行列の逐次生成の開始（等間隔の計算時刻用）
+ *             * 以降の next_rw で、UT1, TAI から計算間隔毎の計算時刻の
+ *               回転行列・地球自転項の行列を順に生成する
+ *             * 直接計算し直す間隔は kRotChunk 回と1日の短い方
+ *               (GMST の変化率の変化・運動項の変化を無視できる範囲)
+ *             * 現在の日時(set_time)は next_rw で変更される
+ *
+ * @param[in]  UT1(開始) (timespec)
+ * @param[in]  TAI(開始) (timespec)
+ * @param[in]  計算間隔(秒) (double; 0 なら毎回直接計算)
+ */
+void Blh::start_rw(struct timespec ut1, struct timespec tai, double step) {
+  rs_ut1  = ut1;
+  rs_tai  = tai;
+  rs_step = step;
+  rs_k    = 0;
+  rs_n    = (step > 0.0 && step < kSecD)
+          ? std::min(static_cast<unsigned long>(kSecD / step),
+                     static_cast<unsigned long>(kRotChunk))
+          : 1;
+}
+
+/*
+ * @brief      回転行列の逐次生成（次の計算時刻）
+ *             * GMST は等間隔の計算時刻毎にほぼ一定の角度ずつ進むため、
+ *               cos, sin を加法定理で1回分ずつ進める
+ *               (c' = c cos(d) - s sin(d), s' = s cos(d) + c sin(d))
+ *             * 丸め誤差で c^2 + s^2 が 1 からずれないよう、kRotNorm 回毎に
+ *               正規化する（Newton 法1回; 平方根を使わない）
+ *             * rs_n 回毎（と最初）は gen_mtx_rw と同じく直接計算し、
+ *               増分 d = dGMST/dt * 計算間隔 を求め直す
+ *             * gen_mtx_rw との差は回転角 3e-11 rad 以下（直接計算自体の丸め
+ *               誤差(JCN の桁数)と同程度; 高度 400 km で 2e-7 km）
+ *
+ * @param[out] 回転行列(3x3) (Mtx3)
+ * @param[out] 地球自転項の行列(3x3) (Mtx3)
+ */
+void Blh::next_rw(Mtx3& mtx_r, Mtx3& mtx_w) {
+  double ang;
+  double c;
+  double s;
+  double f;
+
+  try {
+    if (rs_k % rs_n == 0) {
+      set_time(ts_add(rs_ut1, rs_k * rs_step), ts_add(rs_tai, rs_k * rs_step));
+      ang   = calc_gmst_g();
+      rs_c  = cos(ang);
+      rs_s  = sin(ang);
+      ang   = calc_gmst_rate() * rs_step;
+      rs_cd = cos(ang);
+      rs_sd = sin(ang);
+    } else {
+      c = rs_c * rs_cd - rs_s * rs_sd;
+      s = rs_s * rs_cd + rs_c * rs_sd;
+      if (rs_k % kRotNorm == 0) {
+        f = 1.5 - 0.5 * (c * c + s * s);
+        c *= f;
+        s *= f;
+      }
+      rs_c = c;
+      rs_s = s;
+    }
+    ++rs_k;
+    gen_mtx_rw_z(gen_mtx_rz_cs(rs_c, rs_s), mtx_r, mtx_w);
+  } catch (...) {
+    throw;
+  }
+}
+
+/*
+ * @brief      ECEF -> BLH
+ *
+ * @param[in]  ECEF 座標 (Coord)
+ * @return     BLH  座標 (CoordBlh)
+ *             (x -> b, y -> l, z -> h と読み替え)
+ */
+CoordBlh Blh::ecef2blh(Coord ecef) {
+  double   x;
+  double   y;
+  double   z;
+  double   p;
+  double   theta;
+  CoordBlh blh;
+
+  try {
+    x = ecef.x * 1.0e3;
+    y = ecef.y * 1.0e3;
+    z = ecef.z * 1.0e3;
+    p = sqrt(x * x + y * y);
+    theta = atan2(z * kA, p * kB) / kPi180;
+    blh.b = atan2(
+      z + kEd2 * kB * pow(sin(theta * kPi180), 3),
+      p - kE2  * kA * pow(cos(theta * kPi180), 3)
+    ) / kPi180;                                 // Beta(Latitude)
+    blh.l = atan2(y, x) / kPi180;                // Lambda(Longitude)
+    blh.h = (p / cos(blh.b * kPi180)) - n(blh.b);  // Height
+  } catch (...) {
+    throw;
+  }
+
+  return blh;
+}
+
+/*
+ * @brief      対地速度・方位の計算
+ *             * ECEF 速度を直下点の局所座標(東・北)へ分解し、直下点の
+ *               地表面(楕円体)上の速さに換算する
+ *               (北: M / (M + h) 倍, 東: N / (N + h) 倍;
+ *                M: 子午線曲率半径, N: 卯酉線曲率半径)
+ *             * 方位は ECEF 速度の水平成分の向き
+ *
+ * @param[in]  BLH 座標 (CoordBlh; 緯度・経度(°), 高度(km))
+ * @param[in]  速度(ECEF; km/s) (Coord)
+ * @return     対地速度・方位 (PvGnd)
+ */
+PvGnd Blh::ecef2gnd(const CoordBlh& blh, const Coord& v) {
+  double sb;   // sin(緯度)
+  double cb;   // cos(緯度)
+  double sl;   // sin(経度)
+  double cl;   // cos(経度)
+  double w;    // sqrt(1 - e^2 sin^2(緯度))
+  double rn;   // 卯酉線曲率半径(km)
+  double rm;   // 子午線曲率半径(km)
+  double v_e;  // 速度(東)
+  double v_n;  // 速度(北)
+  PvGnd  gnd;
+
+  try {
+    sb  = sin(blh.b * kPi180);
+    cb  = cos(blh.b * kPi180);
+    sl  = sin(blh.l * kPi180);
+    cl  = cos(blh.l * kPi180);
+    w   = sqrt(1.0 - kE2 * sb * sb);
+    rn  = kA / w * 1.0e-3;
+    rm  = kA * (1.0 - kE2) / (w * w * w) * 1.0e-3;
+    v_e = -sl * v.x + cl * v.y;
+    v_n = -sb * cl * v.x - sb * sl * v.y + cb * v.z;
+    gnd.v   = v;
+    gnd.spd = sqrt(pow(v_e * rn / (rn + blh.h), 2)
+                 + pow(v_n * rm / (rm + blh.h), 2));
+    gnd.hdg = atan2(v_e, v_n) / kPi180;
+    if (gnd.hdg < 0.0) { gnd.hdg += 360.0; }
+  } catch (...) {
+    throw;
+  }
+
+  return gnd;
+}
+
 /********************************************
  **** 以下、 private function/procedures ****
  ********************************************/
 
+/*
+ * @brief   GMST 回転行列生成
+ *          * GMST（運動項適用後）による z軸を中心とした回転
+ *            （現在の日時(UT1, TT)のもの）
+ *
+ * @param   <none>
+ * @return  回転行列(3x3) (Mtx3)
+ */
+Mtx3 Blh::gen_mtx_gmst() {
+  Mtx3 mtx_z;
+
+  try {
+    // GMST 回転行列（z軸を中心とした回転）
+    mtx_z = gen_mtx_rz(calc_gmst_g());
+  } catch (...) {
+    throw;
+  }
+
+  return mtx_z;
+}
+
+/*
+ * @brief      回転行列・地球自転項の行列生成（GMST 回転行列指定）
+ *             * 回転行列 = R_pm * R_z
+ *             * 地球自転項の行列 = R_pm * [ω_earth ×] * R_z
+ *
+ * @param[in]  GMST 回転行列(3x3) (Mtx3)
+ * @param[out] 回転行列(3x3) (Mtx3)
+ * @param[out] 地球自転項の行列(3x3) (Mtx3)
+ */
+void Blh::gen_mtx_rw_z(const Mtx3& mtx_z, Mtx3& mtx_r, Mtx3& mtx_w) {
+  Coord om_e;
+  Mtx3  mtx_x = {};  // ω_earth との外積の行列
+
+  try {
+    mtx_r = mul_mtx(mtx_pm, mtx_z);
+    om_e  = calc_om_e();
+    mtx_x[0][1] = -om_e.z;
+    mtx_x[1][0] =  om_e.z;
+    mtx_w = mul_mtx(mtx_pm, mul_mtx(mtx_x, mtx_z));
+  } catch (...) {
+    throw;
+  }
+}
+
+/*
+ * @brief   GMST（運動項適用後）計算
+ *          * 現在の日時(UT1, TT)のもの
+ *
+ * @param   <none>
+ * @return  GMST (運動項適用後; rad) (double)
+ */
+double Blh::calc_gmst_g() {
+  double gmst;
+  double om;
+  double gmst_g;
+
+  try {
+    // GMST（グリニッジ平均恒星時）計算
+    gmst   = calc_gmst();
+    // Ω（月の平均昇交点黄経）計算（IAU1980章動理論）
+    om     = calc_om();
+    // GMST に運動項を適用（1997年より新しい場合）
+    gmst_g = apply_kinematic(gmst, om);
+  } catch (...) {
+    throw;
+  }
+
+  return gmst_g;
+}
+
 /*
  * @brief   GMST（グリニッジ平均恒星時）計算
  *          * IAU1982理論(by David Vallado)によるもの
@@ -123,7 +413,7 @@ double Blh::calc_gmst() {
   double gmst;
 
   try {
-    t_ut1 = (jd_ut1 - kJ2k) / kDayJc;
+    t_ut1 = jcn_ut1;
     gmst = 67310.54841 + (876600.0 * 3600.0 + 8640184.812866
          + (0.093104 -  6.2e-6 * t_ut1) * t_ut1) * t_ut1;
     gmst = fmod(gmst * kPi180 / 240.0, kPi2);
@@ -136,6 +426,32 @@ double Blh::calc_gmst() {
   return gmst;
 }
 
+/*
+ * @brief   GMST の変化率（UT1 の1秒あたり）計算
+ *          * calc_gmst の多項式の微分
+ *              dGMST/dT = (876600 * 3600 + 8640184.812866)s
+ *                       + 2 * 0.093104s T - 3 * 0.0000062s T^2
+ *          * 運動項の変化率（1e-16 rad/s 程度）は含めない
+ *
+ * @param   <none>
+ * @return  GMST の変化率(rad/s) (double)
+ */
+double Blh::calc_gmst_rate() {
+  double t_ut1;
+  double rate;
+
+  try {
+    t_ut1 = jcn_ut1;
+    rate = 876600.0 * 3600.0 + 8640184.812866
+         + (2.0 * 0.093104 - 3.0 * 6.2e-6 * t_ut1) * t_ut1;
+    rate = rate * kPi180 / 240.0 / (kDayJc * kSecD);
+  } catch (...) {
+    throw;
+  }
+
+  return rate;
+}
+
 /*
  * @brief   Ω（月の平均昇交点黄経）計算（IAU1980章動理論）
  *          * Ω = 125°02′40″.280
@@ -196,16 +512,31 @@ double Blh::apply_kinematic(double gmst, double om) {
  * @brief      z 軸を軸とした座標軸回転行列
  *
  * @param[in]  回転量(rad) (double)
- * @return     回転行列(3x3) (vector<vector<double>>)
+ * @return     回転行列(3x3) (Mtx3)
  */
-std::vector<std::vector<double>> Blh::gen_mtx_rz(double ang) {
-  double c;
-  double s;
-  std::vector<std::vector<double>> mtx(3, std::vector<double>(3, 0.0));
+Mtx3 Blh::gen_mtx_rz(double ang) {
+  Mtx3 mtx;
+
+  try {
+    mtx = gen_mtx_rz_cs(cos(ang), sin(ang));
+  } catch (...) {
+    throw;
+  }
+
+  return mtx;
+}
+
+/*
+ * @brief      z 軸を軸とした座標軸回転行列（cos, sin 指定）
+ *
+ * @param[in]  cos(回転量) (double)
+ * @param[in]  sin(回転量) (double)
+ * @return     回転行列(3x3) (Mtx3)
+ */
+Mtx3 Blh::gen_mtx_rz_cs(double c, double s) {
+  Mtx3 mtx = {};
 
   try {
-    c = cos(ang);
-    s = sin(ang);
     mtx[0][0] =   c;
     mtx[0][1] =   s;
     mtx[1][0] =  -s;
@@ -222,9 +553,9 @@ std::vector<std::vector<double>> Blh::gen_mtx_rz(double ang) {
  * @brief   極運動の座標軸回転行列
  *
  * @param   <none>
- * @return  回転行列(3x3) (vector<vector<double>>)
+ * @return  回転行列(3x3) (Mtx3)
  */
-std::vector<std::vector<double>> Blh::gen_mtx_rpm() {
+Mtx3 Blh::gen_mtx_rpm() {
   double pm_x_r;
   double pm_y_r;
   double conv;
@@ -235,7 +566,7 @@ std::vector<std::vector<double>> Blh::gen_mtx_rpm() {
   double sp;
   double s_sp;
   double c_sp;
-  std::vector<std::vector<double>> mtx(3, std::vector<double>(3, 0.0));
+  Mtx3   mtx;
 
   try {
     pm_x_r = pm_x * kPi / (180.0 * 60.0 * 60.0 * 1000.0);
@@ -265,14 +596,41 @@ std::vector<std::vector<double>> Blh::gen_mtx_rpm() {
   return mtx;
 }
 
+/*
+ * @brief      回転行列の積
+ *
+ * @param[in]  回転行列(3x3) (Mtx3)
+ * @param[in]  回転行列(3x3) (Mtx3)
+ * @return     回転行列(3x3) (Mtx3)
+ */
+Mtx3 Blh::mul_mtx(const Mtx3& mtx_a, const Mtx3& mtx_b) {
+  unsigned int i;
+  unsigned int j;
+  Mtx3         mtx;
+
+  try {
+    for (i = 0; i < 3; ++i) {
+      for (j = 0; j < 3; ++j) {
+        mtx[i][j] = mtx_a[i][0] * mtx_b[0][j]
+                  + mtx_a[i][1] * mtx_b[1][j]
+                  + mtx_a[i][2] * mtx_b[2][j];
+      }
+    }
+  } catch (...) {
+    throw;
+  }
+
+  return mtx;
+}
+
 /*
  * @brief       回転行列適用
  *
- * @param[in]  回転行列(3x3) (vector<vector<double>>)
+ * @param[in]  回転行列(3x3) (Mtx3)
  * @param[in]  座標（回転前）(Coord)
  * @return     座標（回転後）(Coord)
  */
-Coord Blh::apply_mtx(std::vector<std::vector<double>> mtx_r, Coord cd_src) {
+Coord Blh::apply_mtx(const Mtx3& mtx_r, const Coord& cd_src) {
   Coord cd;
 
   try {
@@ -310,27 +668,6 @@ Coord Blh::calc_om_e() {
   return om_e;
 }
 
-/*
- * @brief   ベクトルの外積計算
- *
- * @param[in]  ベクトル (Coord)
- * @param[in]  ベクトル (Coord)
- * @return     ベクトルの外積 (Coord)
- */
-Coord Blh::v_cross(Coord cd_a, Coord cd_b) {
-  Coord cd = {0.0, 0.0, 0.0};
-
-  try {
-    cd.x = cd_a.y * cd_b.z - cd_a.z * cd_b.y;
-    cd.y = cd_a.z * cd_b.x - cd_a.x * cd_b.z;
-    cd.z = cd_a.x * cd_b.y - cd_a.y * cd_b.x;
-  } catch (...) {
-    throw;
-  }
-
-  return cd;
-}
-
 /*
  * @brief      関数 N (ECEF -> BLH 変換処理用)
  *
@@ -349,39 +686,5 @@ double Blh::n(double x) {
   return res;
 }
 
-/*
- * @brief      ECEF -> BLH
- *
- * @param[in]  ECEF 座標 (Coord)
- * @return     BLH  座標 (CoordBlh)
- *             (x -> b, y -> l, z -> h と読み替え)
- */
-CoordBlh Blh::ecef2blh(Coord ecef) {
-  double   x;
-  double   y;
-  double   z;
-  double   p;
-  double   theta;
-  CoordBlh blh;
-
-  try {
-    x = ecef.x * 1.0e3;
-    y = ecef.y * 1.0e3;
-    z = ecef.z * 1.0e3;
-    p = sqrt(x * x + y * y);
-    theta = atan2(z * kA, p * kB) / kPi180;
-    blh.b = atan2(
-      z + kEd2 * kB * pow(sin(theta * kPi180), 3),
-      p - kE2  * kA * pow(cos(theta * kPi180), 3)
-    ) / kPi180;                                 // Beta(Latitude)
-    blh.l = atan2(y, x) / kPi180;                // Lambda(Longitude)
-    blh.h = (p / cos(blh.b * kPi180)) - n(blh.b);  // Height
-  } catch (...) {
-    throw;
-  }
-
-  return blh;
-}
-
 }  // namespace iss_sgp4_json
 
@@ -4,6 +4,8 @@
 #include "sgp4.hpp"
 #include "time.hpp"
 
+#include <algorithm>
+#include <array>
 #include <iomanip>
 #include <string>
 #include <vector>
@@ -21,30 +23,70 @@ struct PvBlh {
   CoordBlh r;  // 位置
   double   v;  // 速度
 };
+// 位置・速度構造体(ECEF)
+struct PvEcef {
+  Coord r;  // 位置(km)
+  Coord v;  // 速度(km/s)
+};
+// 対地速度構造体
+struct PvGnd {
+  Coord  v;    // 速度(ECEF; km/s)
+  double spd;  // 対地速度(直下点の地表面上の速さ; km/s)
+  double hdg;  // 方位(北から時計回り; 0 .. 360°)
+};
+
+// 回転行列(3x3)
+using Mtx3 = std::array<std::array<double, 3>, 3>;
 
 class Blh{
   double pm_x;    // 極運動(x)
   double pm_y;    // 極運動(y)
   double lod;     // LOD
   double jd_ut1;  // JD(UT1)
+  double jcn_ut1; // JCN(UT1)
   double jcn_tt;  // JCN(TT)
+  Mtx3   mtx_pm;  // 極運動の回転行列（1日の間は一定とみなす）
+  // [ 回転行列の逐次生成（等間隔の計算時刻用） ]
+  struct timespec rs_ut1;    // UT1(開始)
+  struct timespec rs_tai;    // TAI(開始)
+  double          rs_step;   // 計算間隔(秒)
+  unsigned long   rs_k;      // 次の計算時刻の番号
+  unsigned long   rs_n;      // 直接計算し直す間隔(回)
+  double          rs_c;      // cos(GMST)(現在の計算時刻)
+  double          rs_s;      // sin(GMST)(現在の計算時刻)
+  double          rs_cd;     // cos(GMST の1回分の増分)
+  double          rs_sd;     // sin(GMST の1回分の増分)
 
 public:
   Blh(struct timespec, struct timespec, double, double, double);  // コンストラクタ
-  PvBlh teme2blh(PvTeme);                  // TEME -> BLH
+  void set_time(struct timespec, struct timespec);  // 日時(UT1, TAI)の変更
+  PvBlh teme2blh(const PvTeme&);           // TEME -> BLH
+  PvEcef teme2ecef(const PvTeme&);         // TEME -> ECEF(位置・速度)
+  Mtx3 gen_mtx_r();                        // TEME -> ECEF 回転行列生成
+  void gen_mtx_rw(Mtx3&, Mtx3&);           // TEME -> ECEF 回転行列・地球自転項の行列生成
+  void start_rw(struct timespec, struct timespec, double);
+                                           // 回転行列の逐次生成の開始(等間隔)
+  void next_rw(Mtx3&, Mtx3&);              // 回転行列の逐次生成(次の計算時刻)
+  CoordBlh ecef2blh(Coord);                // ECEF -> BLH
+  static PvGnd ecef2gnd(const CoordBlh&, const Coord&);
+                                           // 対地速度・方位の計算
 
 private:
+  Mtx3 gen_mtx_gmst();                     // GMST 回転行列生成
+  void gen_mtx_rw_z(const Mtx3&, Mtx3&, Mtx3&);
+                                           // 回転行列・地球自転項の行列生成(GMST 回転行列指定)
+  double calc_gmst_g();                    // GMST (運動項適用後) 計算
   double calc_gmst();                      // GMST (グリニッジ平均恒星時) 計算
+  double calc_gmst_rate();                 // GMST の変化率(rad/s) 計算
   double calc_om();                        // Ω (月の平均昇交点黄経; IAU1980章動理論) 計算
   double apply_kinematic(double, double);  // GMST に運動項を適用(1997年より新しい場合)
-  std::vector<std::vector<double>> gen_mtx_rz(double);   // z軸を中心とした座標軸回転行列生成
-  std::vector<std::vector<double>> gen_mtx_rpm();
-                                           // 極運動の座標軸回転行列生成
-  Coord apply_mtx(std::vector<std::vector<double>>, Coord);  // 回転行列適用
+  Mtx3 gen_mtx_rz(double);                 // z軸を中心とした座標軸回転行列生成
+  Mtx3 gen_mtx_rz_cs(double, double);      // z軸を中心とした座標軸回転行列生成(cos, sin 指定)
+  Mtx3 gen_mtx_rpm();                      // 極運動の座標軸回転行列生成
+  Mtx3 mul_mtx(const Mtx3&, const Mtx3&);  // 回転行列の積
+  Coord apply_mtx(const Mtx3&, const Coord&);  // 回転行列適用
   Coord calc_om_e();                       // Ω_earch 計算
-  Coord v_cross(Coord, Coord);             // ベクトルの外積計算
   double n(double);                        // 関数 N (ECEF -> BLH 変換処理用)
-  CoordBlh ecef2blh(Coord);                // ECEF -> BLH
 };
 
 }  // namespace iss_sgp4_json
@@ -0,0 +1,151 @@
+#include "blh_simd.hpp"
+
+#include "vmath.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace iss_sgp4_json {
+
+// 定数
+static constexpr double kDeg   = 180.0 / kPi;  // 180.0 / 円周率
+static constexpr double kRMin2 = 1.0e6;        // 近似 cbrt を使う地心距離の下限^2(km^2)
+// [ WGS84 座標パラメータ(km) ]
+// a(地球楕円体長半径(赤道面平均半径))
+static constexpr double kA   = 6378.137;
+// 1 / f(地球楕円体扁平率=(a - b) / a)
+static constexpr double k1F  = 298.257223563;
+// b(地球楕円体短半径)
+static constexpr double kB   = kA * (1.0 - 1.0 / k1F);
+// a^2, b^2
+static constexpr double kA2  = kA * kA;
+static constexpr double kB2  = kB * kB;
+// e^2 = 2 * f - f * f
+static constexpr double kE2  = (1.0 / k1F) * (2.0 - (1.0 / k1F));
+// e^4
+static constexpr double kE4  = kE2 * kE2;
+// e'^2= (a^2 - b^2) / b^2
+static constexpr double kEd2 = kE2 * kA2 / kB2;
+
+/*
+ * @brief      cbrt(u) (分岐なし; 1 <= u <= 1.25)
+ *             * 1 の周りの2次の展開を初期値とし、Halley 法を2回
+ *               (初期値の相対誤差 1e-3 以下 -> 1e-9 -> 丸め誤差)
+ *
+ * @param[in]  u (double; 1 .. 1.25)
+ * @return     cbrt(u) (double)
+ */
+static inline double v_cbrt1(double u) {
+  double d = u - 1.0;
+  double y = 1.0 + d * (1.0 / 3.0 - d * (1.0 / 9.0));
+  double y3;
+
+  y3 = y * y * y;
+  y  = y * (y3 + 2.0 * u) / (2.0 * y3 + u);
+  y3 = y * y * y;
+  y  = y * (y3 + 2.0 * u) / (2.0 * y3 + u);
+  return y;
+}
+
+/*
+ * @brief      ECEF -> BLH（Heikkinen の閉形式; 1点分）
+ *             * 反復を含まない厳密解（誤差は丸め誤差のみ）
+ *             * kVec == true なら分岐なし(cbrt, atan2 は vmath/v_cbrt1;
+ *               地心距離 kRMin2 以上のみ有効)、false なら libm
+ *             * pow は使わず乗算で計算する
+ *             * target_clones の各版へ展開されるよう、常にインライン展開する
+ *
+ * @param[in]  ECEF 座標(x; km) (double)
+ * @param[in]  ECEF 座標(y; km) (double)
+ * @param[in]  ECEF 座標(z; km) (double)
+ * @param[out] 緯度(°) (double)
+ * @param[out] 経度(°) (double)
+ * @param[out] 高度(km) (double)
+ */
+template <bool kVec>
+__attribute__((always_inline))
+static inline void heikkinen(
+    double x, double y, double z, double& b, double& l, double& h) {
+  double p2 = x * x + y * y;
+  double p  = std::sqrt(p2);
+  double z2 = z * z;
+  double f  = 54.0 * kB2 * z2;
+  double g  = p2 + (1.0 - kE2) * z2 - kE2 * (kA2 - kB2);
+  double c  = kE4 * f * p2 / (g * g * g);
+  double u  = 1.0 + c + std::sqrt(c * c + 2.0 * c);
+  double s  = kVec ? v_cbrt1(u) : std::cbrt(u);
+  double k  = s + 1.0 + 1.0 / s;
+  double pp = f / (3.0 * k * k * g * g);
+  double q  = std::sqrt(1.0 + 2.0 * kE4 * pp);
+  double r0 = -pp * kE2 * p / (1.0 + q)
+            + std::sqrt(std::max(0.0, 0.5 * kA2 * (1.0 + 1.0 / q)
+            - pp * (1.0 - kE2) * z2 / (q * (1.0 + q)) - 0.5 * pp * p2));
+  double t  = p - kE2 * r0;
+  double uu = std::sqrt(t * t + z2);
+  double vv = std::sqrt(t * t + (1.0 - kE2) * z2);
+  double z0 = kB2 * z / (kA * vv);
+
+  h = uu * (1.0 - kB2 / (kA * vv));
+  b = (kVec ? v_atan2(z + kEd2 * z0, p) : std::atan2(z + kEd2 * z0, p))
+    * kDeg;
+  l = (kVec ? v_atan2(y, x) : std::atan2(y, x)) * kDeg;
+}
+
+/*
+ * @brief      ECEF -> BLH（要素毎のループ; ベクトル化される）
+ *             * 実行時に CPU に応じた命令セット(AVX-512/AVX2/既定)の版が
+ *               選択される
+ *
+ * @param[in]  件数 (unsigned int)
+ * @param[in]  ECEF 座標(x; km) (const double*)
+ * @param[in]  ECEF 座標(y; km) (const double*)
+ * @param[in]  ECEF 座標(z; km) (const double*)
+ * @param[out] 緯度(°) (double*)
+ * @param[out] 経度(°) (double*)
+ * @param[out] 高度(km) (double*)
+ */
+__attribute__((target_clones("avx512f", "avx2", "default")))
+static void geod_n(
+    unsigned int n, const double* __restrict x, const double* __restrict y,
+    const double* __restrict z, double* __restrict b, double* __restrict l,
+    double* __restrict h) {
+  unsigned int i;
+
+  for (i = 0; i < n; ++i) {
+    heikkinen<true>(x[i], y[i], z[i], b[i], l[i], h[i]);
+  }
+}
+
+/*
+ * @brief      ECEF -> BLH（一括; 閉形式）
+ *             * Blh::ecef2blh (Bowring の1回近似)の代わりに、Heikkinen の
+ *               閉形式で配列をまとめて変換する
+ *             * 地心距離が 1,000 km 未満の点（近似 cbrt の範囲外）は libm で
+ *               計算し直す
+ *             * 厳密解(long double)との差は緯度・経度 3e-14°, 高度 2e-10 km 以下
+ *             * Blh::ecef2blh との差（Bowring の1回近似の誤差）は、
+ *               高度 1,000 km 以下で緯度 5e-8°, 高度 8e-6 km 以下、
+ *               36,000 km 以下で緯度 5e-7°, 高度 3.1e-4 km 以下
+ *             * 入力・出力の配列は重ならないこと
+ *
+ * @param[in]  件数 (unsigned int)
+ * @param[in]  ECEF 座標(x; km) (const double*)
+ * @param[in]  ECEF 座標(y; km) (const double*)
+ * @param[in]  ECEF 座標(z; km) (const double*)
+ * @param[out] 緯度(°) (double*)
+ * @param[out] 経度(°) (double*)
+ * @param[out] 高度(km) (double*)
+ */
+void ecef2blh_batch(
+    unsigned int n, const double* x, const double* y, const double* z,
+    double* b, double* l, double* h) {
+  unsigned int i;
+
+  geod_n(n, x, y, z, b, l, h);
+  for (i = 0; i < n; ++i) {
+    if (x[i] * x[i] + y[i] * y[i] + z[i] * z[i] >= kRMin2) { continue; }
+    heikkinen<false>(x[i], y[i], z[i], b[i], l[i], h[i]);
+  }
+}
+
+}  // namespace iss_sgp4_json
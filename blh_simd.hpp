@@ -0,0 +1,12 @@
+#ifndef ISS_SGP4_JSON_BLH_SIMD_HPP_
+#define ISS_SGP4_JSON_BLH_SIMD_HPP_
+
+namespace iss_sgp4_json {
+
+void ecef2blh_batch(
+    unsigned int, const double*, const double*, const double*,
+    double*, double*, double*);  // ECEF -> BLH（一括; 閉形式）
+
+}  // namespace iss_sgp4_json
+
+#endif
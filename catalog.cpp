@@ -0,0 +1,123 @@
+#include "catalog.hpp"
+
+#include "prof.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+
+namespace iss_sgp4_json {
+
+// 定数
+static constexpr double       kSecDay = 86400.0;  // Seconds per day
+static constexpr unsigned int kLenTle = 69;       // TLE 1行の長さ
+
+/*
+ * @brief      コンストラクタ
+ *
+ * @param[in]  カタログファイル名 (string)
+ */
+Catalog::Catalog(std::string f) {
+  ProfTimer pt(Stage::kTle);
+
+  n_skip = 0;
+  load(f);
+  if (recs.size() == 0) {
+    std::cerr << "[ERROR] TLE data could not be found in " << f << "!"
+              << std::endl;
+    std::exit(EXIT_FAILURE);
+  }
+}
+
+/********************************************
+ **** 以下、 private function/procedures ****
+ ********************************************/
+
+/*
+ * @brief      カタログ読み込み
+ *             * 3行形式(衛星名 + TLE)・2行形式(TLE のみ)のどちらも可
+ *               (衛星名の先頭の "0 " は除く)
+ *             * 衛星番号が同じ TLE は元期が最新のものだけを残す
+ *             * 衛星番号が5桁の数字でない(Alpha-5 等)・1行目と2行目で
+ *               衛星番号が異なる・長さが足りない TLE は読み飛ばす
+ *
+ * @param[in]  カタログファイル名 (string)
+ */
+void Catalog::load(std::string f) {
+  std::string  buf;   // 1行分バッファ
+  std::string  name;  // 衛星名(直前の行)
+  unsigned int y;     // year
+  double       d;     // day
+  CatRec       rec;   // カタログレコード
+  std::vector<CatRec>::iterator it;
+
+  try {
+    // ファイル OPEN
+    std::ifstream ifs(f);
+    if (!ifs) {
+      std::cerr << "[ERROR] " << f << " could not be opened!" << std::endl;
+      std::exit(EXIT_FAILURE);
+    }
+
+    // ファイル READ（2行目を読んだ時点で1件とする）
+    rec.tle.resize(2);
+    while (getline(ifs, buf)) {
+      if (!buf.empty() && buf.back() == '\r') { buf.pop_back(); }
+      if (buf.compare(0, 2, "1 ") == 0) {
+        rec.tle[0] = buf;
+        continue;
+      }
+      if (buf.compare(0, 2, "2 ") != 0 || rec.tle[0] == "") {
+        // 衛星名
+        name = buf.compare(0, 2, "0 ") == 0 ? buf.substr(2) : buf;
+        name.erase(name.find_last_not_of(' ') + 1);
+        rec.tle[0] = "";
+        continue;
+      }
+      rec.tle[1] = buf;
+      try {
+        if (rec.tle[0].size() < kLenTle || rec.tle[1].size() < kLenTle) {
+          throw std::invalid_argument("length");
+        }
+        if (!std::all_of(rec.tle[0].begin() + 2, rec.tle[0].begin() + 7,
+                         [](unsigned char c) { return std::isdigit(c); }) ||
+            rec.tle[1].compare(2, 5, rec.tle[0], 2, 5) != 0) {
+          throw std::invalid_argument("satnum");
+        }
+        rec.satnum = std::stoul(rec.tle[0].substr(2, 5));
+        y = std::stoul(rec.tle[0].substr(18, 2));
+        d = std::stod(rec.tle[0].substr(20, 12));
+        y += y < 57 ? 2000 : 1900;
+        rec.name  = name;
+        rec.epoch = ts_add(dt2ts({y, 1, 1, 0, 0, 0.0}), (d - 1.0) * kSecDay);
+        recs.push_back(rec);
+      } catch (const std::logic_error&) {
+        ++n_skip;
+      }
+      rec.tle[0] = "";
+      name = "";
+    }
+
+    // 衛星番号順（同一衛星番号は元期が最新のもの）
+    std::stable_sort(recs.begin(), recs.end(),
+        [](const CatRec& a, const CatRec& b) {
+          return a.satnum < b.satnum;
+        });
+    it = recs.begin();
+    for (const CatRec& r : recs) {
+      if (it != recs.begin() && (it - 1)->satnum == r.satnum) {
+        if (r.epoch.tv_sec >= (it - 1)->epoch.tv_sec) { *(it - 1) = r; }
+        continue;
+      }
+      *it++ = r;
+    }
+    recs.erase(it, recs.end());
+  } catch (...) {
+    throw;
+  }
+}
+
+}  // namespace iss_sgp4_json
@@ -0,0 +1,36 @@
+#ifndef ISS_SGP4_JSON_CATALOG_HPP_
+#define ISS_SGP4_JSON_CATALOG_HPP_
+
+#include "time.hpp"
+
+#include <ctime>
+#include <string>
+#include <vector>
+
+namespace iss_sgp4_json {
+
+// カタログ(衛星毎の TLE)レコード構造体
+struct CatRec {
+  unsigned int             satnum;  // 衛星番号
+  std::string              name;    // 衛星名(2行形式なら空)
+  struct timespec          epoch;   // 元期
+  std::vector<std::string> tle;     // TLE(2行)
+};
+
+class Catalog {
+  std::vector<CatRec> recs;  // カタログ（衛星番号順）
+  unsigned int        n_skip;  // 読み飛ばした TLE の件数
+
+public:
+  Catalog(std::string);                        // コンストラクタ
+  const std::vector<CatRec>& get_recs() { return recs; }  // カタログ
+  unsigned int size() { return recs.size(); }  // 衛星数
+  unsigned int skipped() { return n_skip; }    // 読み飛ばした TLE の件数
+
+private:
+  void load(std::string);  // カタログ読み込み
+};
+
+}  // namespace iss_sgp4_json
+
+#endif
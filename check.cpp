@@ -0,0 +1,553 @@
+/***********************************************************
+  回帰テスト（出力・処理速度）
+  : 固定の JST から48時間分を計算し、正解データ
+    (test/golden_20210601090000.json)と項目毎の許容誤差で比較する。また、端から端までの処理速度(件数/秒)を計測し、基準値から
+    指定割合を越えて低下していれば失敗とする。
+    さらに、いくつかの条件でスレッド数 1 と kThr の出力がバイト単位で一致
+    することと、TLE の切り替えを多数またぐ暦の生成(-e)が制限時間内に
+    終わること、EOP データの範囲を越える計算期間がエラー終了すること、
+    計算日数・間隔の上限(36525 日)で時刻計算が正しいことを確認する。
+
+  ---
+  引数 : [オプション]
+         オプション:
+           -g, --golden FILE    正解データ
+                                (既定値: test/golden_20210601090000.json)
+           -b, --base FILE      処理速度の基準値ファイル(既定値: check_base.txt)
+           -r, --regress PCT    処理速度の許容低下率(%; 既定値: 20)
+           -n, --runs N         計測回数(最速値を採用; 既定値: 5)
+           -u, --update         処理速度の基準値ファイルを更新
+           -h, --help           使用方法の表示
+  ---
+  MEMO:
+    * 計算には ./iss_sgp4_json を使用し、結果は check.json に書き込む
+      (比較後に削除; スレッド数の比較は check_t.json, 暦は check_e.bin
+       も使用)
+    * 基準値ファイルが存在しなければ、計測値を基準値として書き込む
+    * 終了ステータス: EXIT_SUCCESS なら合格
+***********************************************************/
+#include "time.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>   // for EXIT_XXXX
+#include <fstream>
+#include <getopt.h>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace iss_sgp4_json {
+
+static constexpr char   kProg[]   = "./iss_sgp4_json";  // 計算プログラム
+static constexpr char   kJst[]    = "20210601090000";   // JST(計算開始)
+static constexpr char   kFOut[]   = "check.json";       // 書き込みファイル
+static constexpr char   kFOutT[]  = "check_t.json";     // 書き込みファイル(スレッド数の比較)
+static constexpr char   kFEph[]   = "check_e.bin";      // 書き込みファイル(暦)
+static constexpr unsigned int kThr = 3;                 // スレッド数(一致の確認)
+static constexpr unsigned int kEphSec = 120;            // 暦の生成の制限時間(秒)
+static constexpr char   kFGold[]  = "test/golden_20210601090000.json";
+                                                        // 正解データ(既定値)
+static constexpr char   kFBase[]  = "check_base.txt";   // 基準値ファイル(既定値)
+static constexpr double kRegress  = 20.0;               // 許容低下率(%; 既定値)
+static constexpr int    kRuns     = 5;                  // 計測回数(既定値)
+static constexpr double kTolLat   = 1.0e-5;             // 許容誤差(緯度; °)
+static constexpr double kTolLon   = 1.0e-5;             // 許容誤差(経度; °)
+static constexpr double kTolH     = 1.0e-4;             // 許容誤差(高度; km)
+static constexpr double kTolV     = 1.0e-6;             // 許容誤差(速度; km/s)
+// スレッド数によらず出力が一致することを確認する条件(オプション)
+static const char* const kIdOpts[] = {
+  "-d 1 -s 1", "-d 20 -s 60", "-d 0.5 -s 1 -H 60", "-d 0.5 -s 1 -a 1"
+};
+// 暦の生成を確認する条件(オプション・JST; TLE の切り替えをまたぐもの)
+static const char* const kEphOpts[] = {
+  "-d 1 20210603000000", "-d 3 20210601090000", "-d 20 20210601090000"
+};
+
+// EOP データ(eop.txt)の範囲を越える条件(オプション・JST; エラー終了すること)
+static constexpr char   kEopOut[] = "-d 40 -s 86400 20210601090000";
+// 計算日数・間隔の上限(秒; iss_sgp4_json の --days/--step の上限 36525 日)
+static constexpr double kSecMax = 36525.0 * 86400.0;
+static constexpr unsigned int kCapSec = 10;             // 上限の計算間隔での実行の制限時間(秒)
+
+// レコード構造体
+struct Rec {
+  std::string jst;  // JST
+  std::string utc;  // UTC
+  double      lat;  // 緯度(°)
+  double      lon;  // 経度(°)
+  double      h;    // 高度(km)
+  double      v;    // 速度(km/s)
+};
+
+// オプション構造体
+struct Opt {
+  std::string gold    = kFGold;    // 正解データ
+  std::string base    = kFBase;    // 基準値ファイル
+  double      regress = kRegress;  // 許容低下率(%)
+  int         runs    = kRuns;     // 計測回数
+  bool        update  = false;     // 基準値ファイルの更新
+};
+
+/*
+ * @brief      JSON 読み込み
+ *             * 本プログラムの出力形式(1行に1項目)のみ対応
+ *
+ * @param[in]  ファイル名 (string)
+ * @param[out] 件数 (long)
+ * @param[out] レコード一覧 (vector<Rec>)
+ * @return     成否 (bool)
+ */
+static bool load(const std::string& f, long& cnt, std::vector<Rec>& recs) {
+  std::string buf;  // 1行分バッファ
+  std::string key;  // 項目名
+  std::string val;  // 値
+  size_t      p;    // 区切り位置
+
+  std::ifstream ifs(f);
+  if (!ifs) { return false; }
+  cnt = -1;
+  recs.clear();
+  while (getline(ifs, buf)) {
+    p = buf.find("\": ");
+    if (p == std::string::npos) { continue; }
+    key = buf.substr(buf.find('"') + 1, p - buf.find('"') - 1);
+    val = buf.substr(p + 3);
+    if (!val.empty() && val.back() == ',') { val.pop_back(); }
+    if (key == "counts") {
+      cnt = std::stol(val);
+    } else if (key == "jst") {
+      recs.push_back({});
+      recs.back().jst = val;
+    } else if (key == "data" || recs.empty()) {
+      continue;
+    } else if (key == "utc") {
+      recs.back().utc = val;
+    } else if (key == "latitude") {
+      recs.back().lat = std::stod(val);
+    } else if (key == "longitude") {
+      recs.back().lon = std::stod(val);
+    } else if (key == "height") {
+      recs.back().h = std::stod(val);
+    } else if (key == "velocity") {
+      recs.back().v = std::stod(val);
+    }
+  }
+
+  return cnt >= 0;
+}
+
+/*
+ * @brief      出力の比較
+ *             * 件数・日時は完全一致、緯度・経度・高度・速度は許容誤差内
+ *             * 経度は ±180° をまたぐ差を考慮する
+ *
+ * @param[in]  正解データ (string)
+ * @param[in]  計算結果 (string)
+ * @return     合否 (bool)
+ */
+static bool compare(const std::string& f_g, const std::string& f_o) {
+  long             cnt_g;  // 件数(正解データ)
+  long             cnt_o;  // 件数(計算結果)
+  std::vector<Rec> rs_g;   // レコード一覧(正解データ)
+  std::vector<Rec> rs_o;   // レコード一覧(計算結果)
+  double           d[4] = {0.0, 0.0, 0.0, 0.0};  // 最大誤差
+  double           d_lon;  // 経度の差
+  size_t           i;      // loop index
+
+  if (!load(f_g, cnt_g, rs_g)) {
+    std::cout << "[ERROR] " << f_g << " could not be read!" << std::endl;
+    return false;
+  }
+  if (!load(f_o, cnt_o, rs_o)) {
+    std::cout << "[ERROR] " << f_o << " could not be read!" << std::endl;
+    return false;
+  }
+  if (cnt_g != cnt_o || rs_g.size() != rs_o.size()
+   || static_cast<long>(rs_o.size()) != cnt_o) {
+    std::cout << "[FAIL] counts: " << cnt_o << " (golden: " << cnt_g << ")"
+              << std::endl;
+    return false;
+  }
+  for (i = 0; i < rs_g.size(); ++i) {
+    if (rs_g[i].jst != rs_o[i].jst || rs_g[i].utc != rs_o[i].utc) {
+      std::cout << "[FAIL] time of record " << i << ": " << rs_o[i].jst
+                << " (golden: " << rs_g[i].jst << ")" << std::endl;
+      return false;
+    }
+    d_lon = std::fabs(rs_o[i].lon - rs_g[i].lon);
+    d[0] = std::max(d[0], std::fabs(rs_o[i].lat - rs_g[i].lat));
+    d[1] = std::max(d[1], std::min(d_lon, 360.0 - d_lon));
+    d[2] = std::max(d[2], std::fabs(rs_o[i].h - rs_g[i].h));
+    d[3] = std::max(d[3], std::fabs(rs_o[i].v - rs_g[i].v));
+  }
+  std::cout << std::scientific << std::setprecision(3)
+            << "[INFO] max diff: latitude "  << d[0] << " deg"
+            << ", longitude " << d[1] << " deg"
+            << ", height "    << d[2] << " km"
+            << ", velocity "  << d[3] << " km/s" << std::endl;
+  if (d[0] > kTolLat || d[1] > kTolLon || d[2] > kTolH || d[3] > kTolV) {
+    std::cout << "[FAIL] results differ beyond tolerance"
+              << " (latitude "  << kTolLat << ", longitude " << kTolLon
+              << ", height "    << kTolH   << ", velocity "  << kTolV << ")"
+              << std::endl;
+    return false;
+  }
+
+  return true;
+}
+
+/*
+ * @brief      ファイル全体の読み込み
+ *
+ * @param[in]  ファイル名 (string)
+ * @param[out] 内容 (string)
+ * @return     成否 (bool)
+ */
+static bool slurp(const std::string& f, std::string& buf) {
+  std::ostringstream oss;
+
+  std::ifstream ifs(f, std::ios::binary);
+  if (!ifs) { return false; }
+  oss << ifs.rdbuf();
+  buf = oss.str();
+
+  return true;
+}
+
+/*
+ * @brief      スレッド数によらない出力の一致の確認
+ *             * 同じ条件をスレッド数 1 と kThr で計算し、出力をバイト単位で
+ *               比較する
+ *
+ * @param[in]  オプション (string)
+ * @return     合否 (bool)
+ */
+static bool same_threads(const std::string& opts) {
+  std::string cmd;    // コマンド
+  std::string buf_1;  // 出力(スレッド数 1)
+  std::string buf_n;  // 出力(スレッド数 kThr)
+  bool        ok;     // 合否
+
+  cmd = std::string(kProg) + " " + opts + " -t 1 -o " + kFOut + " " + kJst
+      + " > /dev/null 2>&1";
+  if (std::system(cmd.c_str()) != 0) {
+    std::cout << "[ERROR] " << cmd << " failed!" << std::endl;
+    return false;
+  }
+  cmd = std::string(kProg) + " " + opts + " -t " + std::to_string(kThr)
+      + " -o " + kFOutT + " " + kJst + " > /dev/null 2>&1";
+  if (std::system(cmd.c_str()) != 0) {
+    std::cout << "[ERROR] " << cmd << " failed!" << std::endl;
+    std::remove(kFOut);
+    return false;
+  }
+  ok = slurp(kFOut, buf_1) && slurp(kFOutT, buf_n) && buf_1 == buf_n;
+  std::remove(kFOut);
+  std::remove(kFOutT);
+  if (ok) {
+    std::cout << "[INFO] identical with -t 1 and -t " << kThr << ": "
+              << opts << std::endl;
+  } else {
+    std::cout << "[FAIL] output differs between -t 1 and -t " << kThr
+              << ": " << opts << std::endl;
+  }
+
+  return ok;
+}
+
+/*
+ * @brief      暦の生成の確認
+ *             * 制限時間(kEphSec 秒)内に正常終了し、暦ファイルが書き込まれる
+ *               こと（TLE の切り替えで同じ区間を繰り返さないこと）
+ *
+ * @param[in]  オプション・JST (string)
+ * @return     合否 (bool)
+ */
+static bool gen_ephem(const std::string& opts) {
+  std::string cmd;  // コマンド
+  std::string buf;  // 暦ファイルの内容
+  bool        ok;   // 合否
+
+  std::remove(kFEph);
+  cmd = "timeout " + std::to_string(kEphSec) + " " + kProg + " -e " + kFEph
+      + " " + opts + " > /dev/null 2>&1";
+  ok = std::system(cmd.c_str()) == 0 && slurp(kFEph, buf) && !buf.empty();
+  std::remove(kFEph);
+  if (ok) {
+    std::cout << "[INFO] ephemeris written: " << opts << std::endl;
+  } else {
+    std::cout << "[FAIL] ephemeris not written within " << kEphSec
+              << " s: " << opts << std::endl;
+  }
+
+  return ok;
+}
+
+/*
+ * @brief      EOP データの範囲を越える計算期間の確認
+ *             * 失敗の終了ステータスとなり、書き込みファイルを作らないこと
+ *
+ * @return     合否 (bool)
+ */
+static bool check_eop_out() {
+  std::string cmd;  // コマンド
+  std::string buf;  // 書き込みファイルの内容
+  bool        ok;   // 合否
+
+  std::remove(kFOut);
+  cmd = std::string(kProg) + " -o " + kFOut + " " + kEopOut
+      + " > /dev/null 2>&1";
+  ok = std::system(cmd.c_str()) != 0 && !slurp(kFOut, buf);
+  std::remove(kFOut);
+  if (ok) {
+    std::cout << "[INFO] rejected beyond EOP data: " << kEopOut << std::endl;
+  } else {
+    std::cout << "[FAIL] not rejected beyond EOP data: " << kEopOut
+              << std::endl;
+  }
+
+  return ok;
+}
+
+/*
+ * @brief      計算日数・間隔の上限での時刻計算の確認
+ *             * 上限(kSecMax 秒)の ts_add が正しく繰り上がり・繰り下がること
+ *             * 上限の計算間隔で制限時間(kCapSec 秒)内に正常終了し、上限を
+ *               越える計算間隔はエラーとなること
+ *
+ * @return     合否 (bool)
+ */
+static bool check_cap() {
+  struct timespec ts;   // 時刻(計算結果)
+  std::string     cmd;  // コマンド
+  bool            ok;   // 合否
+
+  ok = true;
+  ts = ts_add({1622505600, 0}, kSecMax);
+  if (ts.tv_sec != 1622505600 + 3155760000LL || ts.tv_nsec != 0) { ok = false; }
+  ts = ts_add({1622505600, 999999999}, kSecMax + 0.5);
+  if (ts.tv_sec != 1622505601 + 3155760000LL || ts.tv_nsec != 499999999) {
+    ok = false;
+  }
+  ts = ts_add({1622505600, 0}, -(kSecMax + 0.25));
+  if (ts.tv_sec != 1622505599 - 3155760000LL || ts.tv_nsec != 750000000) {
+    ok = false;
+  }
+  if (!ok) {
+    std::cout << "[FAIL] ts_add at the days/step limit" << std::endl;
+    return false;
+  }
+
+  cmd = "timeout " + std::to_string(kCapSec) + " " + kProg + " -d 1 -s "
+      + std::to_string(static_cast<long long>(kSecMax)) + " -o " + kFOut + " "
+      + kJst + " > /dev/null 2>&1";
+  ok = std::system(cmd.c_str()) == 0;
+  std::remove(kFOut);
+  cmd = std::string(kProg) + " -d 1 -s "
+      + std::to_string(static_cast<long long>(kSecMax) + 1) + " -o " + kFOut
+      + " " + kJst + " > /dev/null 2>&1";
+  if (std::system(cmd.c_str()) == 0) { ok = false; }
+  std::remove(kFOut);
+  if (ok) {
+    std::cout << "[INFO] days/step limit: " << std::fixed
+              << std::setprecision(0) << kSecMax << " s" << std::endl;
+  } else {
+    std::cout << "[FAIL] days/step limit: " << std::fixed
+              << std::setprecision(0) << kSecMax << " s" << std::endl;
+  }
+
+  return ok;
+}
+
+/*
+ * @brief      処理速度の計測
+ *             * 計算プログラムを指定回数実行し、最速の件数/秒を返す
+ *
+ * @param[in]  計測回数 (int)
+ * @param[in]  件数 (long)
+ * @return     件数/秒(失敗時は負値) (double)
+ */
+static double measure(int runs, long cnt) {
+  std::string cmd;  // コマンド
+  double      sec;  // 所要時間(秒)
+  double      best; // 所要時間(最速; 秒)
+  int         r;    // loop index
+  std::chrono::steady_clock::time_point t_s;
+
+  cmd  = std::string(kProg) + " -o " + kFOut + " " + kJst;
+  best = -1.0;
+  for (r = 0; r < runs; ++r) {
+    t_s = std::chrono::steady_clock::now();
+    if (std::system(cmd.c_str()) != 0) {
+      std::cout << "[ERROR] " << cmd << " failed!" << std::endl;
+      return -1.0;
+    }
+    sec = std::chrono::duration<double>(
+        std::chrono::steady_clock::now() - t_s).count();
+    if (best < 0.0 || sec < best) { best = sec; }
+  }
+
+  return cnt / best;
+}
+
+/*
+ * @brief      使用方法の表示
+ *
+ * @param[in]  プログラム名 (const char*)
+ */
+static void usage(const char* prog) {
+  std::cout << "Usage: " << prog << " [OPTION]...\n"
+            << "  -g, --golden FILE    golden output\n"
+            << "                       (default: test/golden_20210601090000.json)\n"
+            << "  -b, --base FILE      throughput baseline"
+            << " (default: check_base.txt)\n"
+            << "  -r, --regress PCT    allowed throughput regression in %"
+            << " (default: 20)\n"
+            << "  -n, --runs N         timed runs, best is used (default: 5)\n"
+            << "  -u, --update         rewrite the throughput baseline\n"
+            << "  -h, --help           show this help" << std::endl;
+}
+
+/*
+ * @brief      コマンドライン引数の解析
+ *
+ * @param[in]  引数の数 (int)
+ * @param[in]  引数 (char*[])
+ * @param[out] オプション (Opt)
+ * @return     0: 正常, 1: 終了(ヘルプ表示), -1: エラー (int)
+ */
+static int parse_opt(int argc, char* argv[], Opt& opt) {
+  static const struct option kLongOpts[] = {
+    {"golden",  required_argument, nullptr, 'g'},
+    {"base",    required_argument, nullptr, 'b'},
+    {"regress", required_argument, nullptr, 'r'},
+    {"runs",    required_argument, nullptr, 'n'},
+    {"update",  no_argument,       nullptr, 'u'},
+    {"help",    no_argument,       nullptr, 'h'},
+    {nullptr,   0,                 nullptr,  0 }
+  };
+  int   c;
+  char* e;
+
+  while ((c = getopt_long(argc, argv, "g:b:r:n:uh", kLongOpts, nullptr))
+         != -1) {
+    switch (c) {
+      case 'g':
+        opt.gold = optarg;
+        break;
+      case 'b':
+        opt.base = optarg;
+        break;
+      case 'r':
+        opt.regress = std::strtod(optarg, &e);
+        if (e == optarg || *e != '\0' || !(opt.regress >= 0.0)) {
+          std::cout << "[ERROR] Invalid regress: " << optarg << std::endl;
+          return -1;
+        }
+        break;
+      case 'n':
+        opt.runs = std::strtol(optarg, &e, 10);
+        if (e == optarg || *e != '\0' || opt.runs <= 0) {
+          std::cout << "[ERROR] Invalid runs: " << optarg << std::endl;
+          return -1;
+        }
+        break;
+      case 'u':
+        opt.update = true;
+        break;
+      case 'h':
+        usage(argv[0]);
+        return 1;
+      default:
+        usage(argv[0]);
+        return -1;
+    }
+  }
+  if (optind < argc) {
+    usage(argv[0]);
+    return -1;
+  }
+
+  return 0;
+}
+
+}  // namespace iss_sgp4_json
+
+int main(int argc, char* argv[]) {
+  namespace ns = iss_sgp4_json;
+  ns::Opt          opt;        // オプション
+  int              ret;        // return of functions
+  long             cnt;        // 件数(正解データ)
+  std::vector<ns::Rec> recs;   // レコード一覧(正解データ)
+  double           pps;        // 件数/秒(計測値)
+  double           pps_b = 0;  // 件数/秒(基準値)
+  bool             ok;         // 合否
+
+  try {
+    // オプション解析
+    ret = ns::parse_opt(argc, argv, opt);
+    if (ret > 0) { return EXIT_SUCCESS; }
+    if (ret < 0) { return EXIT_FAILURE; }
+    if (!ns::load(opt.gold, cnt, recs)) {
+      std::cout << "[ERROR] " << opt.gold << " could not be read!"
+                << std::endl;
+      return EXIT_FAILURE;
+    }
+
+    // 処理速度の計測, 出力の比較
+    pps = ns::measure(opt.runs, cnt);
+    if (pps < 0.0) { return EXIT_FAILURE; }
+    ok = ns::compare(opt.gold, ns::kFOut);
+    std::remove(ns::kFOut);
+
+    // スレッド数によらない出力の一致
+    for (const char* o : ns::kIdOpts) {
+      if (!ns::same_threads(o)) { ok = false; }
+    }
+
+    // 暦の生成(TLE の切り替えをまたぐもの)
+    for (const char* o : ns::kEphOpts) {
+      if (!ns::gen_ephem(o)) { ok = false; }
+    }
+
+    // EOP データの範囲を越える計算期間
+    if (!ns::check_eop_out()) { ok = false; }
+
+    // 計算日数・間隔の上限
+    if (!ns::check_cap()) { ok = false; }
+
+    // 処理速度の判定
+    std::cout << std::fixed << std::setprecision(0)
+              << "[INFO] throughput: " << pps << " points/s" << std::endl;
+    std::ifstream ifs(opt.base);
+    if (ifs && !opt.update) { ifs >> pps_b; }
+    if (pps_b > 0.0) {
+      std::cout << "[INFO] baseline: " << pps_b << " points/s ("
+                << std::showpos << std::setprecision(1)
+                << (pps / pps_b - 1.0) * 100.0 << std::noshowpos << "%)"
+                << std::endl;
+      if (pps < pps_b * (1.0 - opt.regress / 100.0)) {
+        std::cout << "[FAIL] throughput regressed by more than "
+                  << opt.regress << "%" << std::endl;
+        ok = false;
+      }
+    } else if (ok) {
+      std::ofstream ofs(opt.base);
+      ofs << std::fixed << std::setprecision(0) << pps << std::endl;
+      std::cout << "[INFO] baseline written to " << opt.base << std::endl;
+    }
+
+    std::cout << (ok ? "[PASS]" : "[FAIL]") << std::endl;
+    if (!ok) { return EXIT_FAILURE; }
+  } catch (...) {
+      std::cerr << "EXCEPTION!" << std::endl;
+      return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,118 @@
+#include "dat.hpp"
+
+#include "prof.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+#include <limits>
+
+namespace iss_sgp4_json {
+
+/*
+ * @brief      コンストラクタ
+ *             * うるう秒ファイルを読み込み、(MJD, DAT) の一覧を保持する
+ *
+ * @param[in]  うるう秒ファイル名 (string; optional)
+ */
+Dat::Dat(std::string f) {
+  std::string buf;  // 1行分バッファ
+  double      mjd;  // MJD
+  int         d;    // 日
+  int         m;    // 月
+  int         y;    // 年
+  DatRec      rec;  // うるう秒レコード
+
+  try {
+    ProfTimer pt(Stage::kDat);
+
+    // ファイル OPEN
+    std::ifstream ifs(f);
+    if (!ifs) {
+      std::cerr << "[ERROR] " << f << " could not be opened!" << std::endl;
+      std::exit(EXIT_FAILURE);
+    }
+
+    // ファイル READ
+    while (getline(ifs, buf)) {
+      if (buf.substr(0, 1) == "#") { continue; }
+      std::istringstream iss(buf);
+      if (!(iss >> mjd >> d >> m >> y >> rec.dat)) { continue; }
+      rec.mjd = static_cast<unsigned int>(mjd);
+      recs.push_back(rec);
+    }
+    std::stable_sort(recs.begin(), recs.end(),
+        [](const DatRec& a, const DatRec& b) { return a.mjd < b.mjd; });
+  } catch (...) {
+    throw;
+  }
+
+  if (recs.size() == 0) {
+    std::cerr << "[ERROR] DAT data could not be found!" << std::endl;
+    std::exit(EXIT_FAILURE);
+  }
+}
+
+/*
+ * @brief      DAT (= TAI - UTC)（うるう秒の総和）取得
+ *
+ * @param[in]  UTC (timespec)
+ * @return     DAT (int)
+ */
+int Dat::get_dat(struct timespec utc) {
+  std::vector<DatRec>::const_iterator it;
+
+  try {
+    ProfTimer pt(Stage::kDat);
+
+    it = find(ts2mjd(utc));
+    if (it == recs.cbegin()) {
+      std::cerr << "[ERROR] DAT data could not be found!" << std::endl;
+      std::exit(EXIT_FAILURE);
+    }
+    --it;
+  } catch (...) {
+    throw;
+  }
+
+  return it->dat;
+}
+
+/*
+ * @brief      次のうるう秒適用日時
+ *             * 指定 UTC より後で DAT が変わる日の 00:00:00(UTC)
+ *             * この日時までは get_dat の結果が変わらない
+ *             * 以降にうるう秒がなければ time_t の最大値
+ *
+ * @param[in]  UTC (timespec)
+ * @return     UTC (timespec)
+ */
+struct timespec Dat::next_leap(struct timespec utc) {
+  std::vector<DatRec>::const_iterator it;
+  struct timespec ts = {std::numeric_limits<time_t>::max(), 0};
+
+  try {
+    it = find(ts2mjd(utc));
+    if (it != recs.cend()) { ts = mjd2ts(it->mjd); }
+  } catch (...) {
+    throw;
+  }
+
+  return ts;
+}
+
+/********************************************
+ **** 以下、 private function/procedures ****
+ ********************************************/
+
+/*
+ * @brief      適用開始日が指定 MJD より後となる最初のレコード
+ *
+ * @param[in]  MJD (unsigned int)
+ * @return     レコード (const_iterator)
+ */
+std::vector<DatRec>::const_iterator Dat::find(unsigned int mjd) {
+  return std::upper_bound(recs.cbegin(), recs.cend(), mjd,
+      [](unsigned int v, const DatRec& rec) { return v < rec.mjd; });
+}
+
+}  // namespace iss_sgp4_json
@@ -0,0 +1,35 @@
+#ifndef ISS_SGP4_JSON_DAT_HPP_
+#define ISS_SGP4_JSON_DAT_HPP_
+
+#include "time.hpp"
+
+#include <ctime>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace iss_sgp4_json {
+
+// うるう秒レコード構造体
+struct DatRec {
+  unsigned int mjd;  // 適用開始日(MJD)
+  int          dat;  // DAT (= TAI - UTC)
+};
+
+class Dat {
+  std::vector<DatRec> recs;  // うるう秒一覧（適用開始日順）
+
+public:
+  Dat(std::string = "Leap_Second.dat");        // コンストラクタ
+  int get_dat(struct timespec);                 // DAT 取得
+  struct timespec next_leap(struct timespec);  // 次のうるう秒適用日時
+
+private:
+  std::vector<DatRec>::const_iterator find(unsigned int);  // 適用開始日の後の最初のレコード
+};
+
+}  // namespace iss_sgp4_json
+
+#endif
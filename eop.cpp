@@ -1,54 +1,127 @@
 #include "eop.hpp"
 
+#include "prof.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
 namespace iss_sgp4_json {
 
 // 定数
-static constexpr char         kFEop[]    = "eop.txt";
-//static constexpr unsigned int kSecDay =  86400;  // Seconds in a day
+static constexpr size_t kColMjd  = 11;  // MJD の桁位置
+static constexpr size_t kColPmX  = 22;  // 極運動(x) の桁位置
+static constexpr size_t kColPmY  = 41;  // 極運動(y) の桁位置
+static constexpr size_t kColDut1 = 62;  // DUT1 の桁位置
+static constexpr size_t kColLod  = 83;  // LOD の桁位置
 
 /*
  * @brief      コンストラクタ
+ *             * EOP ファイルをメモリマップし、行の位置を MJD から求められる
+ *               ようにする（1行の長さが固定であれば行位置は計算で求める）
  *
- * @param[in]  UTC (timespec)
+ * @param[in]  EOP ファイル名 (string; optional)
  */
-Eop::Eop(struct timespec utc) {
-  std::string lod_str;
-  eop = get_eop(utc);
-  if (eop == "") {
-    std::cout << "[ERROR] EOP data could not be found!" << std::endl;
-    std::exit(EXIT_SUCCESS);
+Eop::Eop(std::string f) {
+  int         fd;
+  struct stat st;
+  const char* p;
+  const char* e;
+
+  data  = nullptr;
+  size  = 0;
+  len   = 0;
+  n_rec = 0;
+  mjd_s = 0;
+  try {
+    ProfTimer pt(Stage::kEop);
+
+    // ファイル OPEN, メモリマップ
+    fd = open(f.c_str(), O_RDONLY);
+    if (fd < 0 || fstat(fd, &st) != 0 || st.st_size == 0) {
+      std::cerr << "[ERROR] " << f << " could not be opened!" << std::endl;
+      std::exit(EXIT_FAILURE);
+    }
+    size = st.st_size;
+    p = static_cast<const char*>(
+        mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0));
+    close(fd);
+    if (p == MAP_FAILED) {
+      std::cerr << "[ERROR] " << f << " could not be mapped!" << std::endl;
+      std::exit(EXIT_FAILURE);
+    }
+    data = p;
+
+    // 行の長さ
+    // （ファイルサイズが割り切れても、全行が同じ長さとは限らないため、
+    //   各行の改行位置を確認する）
+    e = static_cast<const char*>(std::memchr(data, '\n', size));
+    if (e != nullptr && size % (e - data + 1) == 0) {
+      len = e - data + 1;
+      for (p = data; p < data + size; p += len) {
+        if (std::memchr(p, '\n', len) != p + len - 1) {
+          len = 0;
+          break;
+        }
+      }
+    }
+    if (len > 0) {
+      n_rec = size / len;
+    } else {
+      // 固定長でない場合は各行の先頭を保持
+      for (p = data; p < data + size; p = e + 1) {
+        rows.push_back(p);
+        e = static_cast<const char*>(std::memchr(p, '\n', data + size - p));
+        if (e == nullptr) { break; }
+      }
+      n_rec = rows.size();
+    }
+    mjd_s = row_mjd(0);
+  } catch (...) {
+    throw;
   }
-  pm_x    = stod(eop.substr(22,  9));
-  pm_y    = stod(eop.substr(41,  9));
-  dut1    = stod(eop.substr(62, 10));
-  lod_str =      eop.substr(83,  7);
-  lod = 0.0;
-  if (lod_str != "       ") { lod = stod(lod_str); }
 }
 
 /*
- * @brief   EOP データ取得
+ * @brief      デストラクタ
+ */
+Eop::~Eop() {
+  if (data != nullptr) {
+    munmap(const_cast<char*>(data), size);
+  }
+}
+
+/*
+ * @brief      EOP データ取得
+ *             * 該当する行がなければエラー終了する
  *
  * @param[in]  UTC (timespec)
- * @return     EOP データ (string)
+ * @return     EOP データ (EopRec)
  */
-std::string Eop::get_eop(struct timespec utc) {
-  std::string f(kFEop);  // ファイル名
-  std::string str_utc;   // 対象の UTC 文字列
-  std::string eop = "";  // EOP データ
+EopRec Eop::get_eop(struct timespec utc) {
+  unsigned int i;      // 行
+  const char*  r;      // 該当行
+  EopRec       eop;    // EOP データ
 
   try {
-    // 対象の UTC 年月日
-    str_utc = gen_time_str(utc).substr(0, 10);
-
-    // ファイル OPEN
-    std::ifstream ifs(f);
-    if (!ifs) throw;  // 読み込み失敗
+    ProfTimer pt(Stage::kEop);
 
-    // ファイル READ
-    while (getline(ifs, eop)) {
-      if (eop.substr(0, 10) == str_utc) { break; }
+    // 行位置の特定（対象の UTC 年月日の MJD）
+    if (!find(ts2mjd(utc), i)) {
+      std::cerr << "[ERROR] EOP data could not be found!" << std::endl;
+      std::exit(EXIT_FAILURE);
     }
+
+    // 各項目の取得
+    r = row(i);
+    eop.pm_x = field(r, kColPmX,   9);
+    eop.pm_y = field(r, kColPmY,   9);
+    eop.dut1 = field(r, kColDut1, 10);
+    eop.lod  = field(r, kColLod,   7);
   } catch (...) {
     throw;
   }
@@ -56,5 +129,95 @@ std::string Eop::get_eop(struct timespec utc) {
   return eop;
 }
 
-}  // namespace iss_sgp4_json
+/*
+ * @brief      EOP データの有無
+ *
+ * @param[in]  UTC (timespec)
+ * @return     有無 (bool)
+ */
+bool Eop::has_eop(struct timespec utc) {
+  unsigned int i;
 
+  return find(ts2mjd(utc), i);
+}
+
+/********************************************
+ **** 以下、 private function/procedures ****
+ ********************************************/
+
+/*
+ * @brief      行位置の特定
+ *             * 行位置は MJD の差から直接求め、一致しなければ二分探索する
+ *
+ * @param[in]  MJD (unsigned int)
+ * @param[out] 行 (unsigned int)
+ * @return     有無 (bool)
+ */
+bool Eop::find(unsigned int mjd, unsigned int& i) {
+  unsigned int lo;     // 二分探索(下限)
+  unsigned int hi;     // 二分探索(上限)
+
+  i = mjd - mjd_s;
+  if (mjd >= mjd_s && i < n_rec && row_mjd(i) == mjd) { return true; }
+  lo = 0;
+  hi = n_rec;
+  while (lo < hi) {
+    i = lo + (hi - lo) / 2;
+    if (row_mjd(i) < mjd) {
+      lo = i + 1;
+    } else {
+      hi = i;
+    }
+  }
+  i = lo;
+
+  return i < n_rec && row_mjd(i) == mjd;
+}
+
+/*
+ * @brief      行の先頭
+ *
+ * @param[in]  行 (unsigned int)
+ * @return     行の先頭 (const char*)
+ */
+const char* Eop::row(unsigned int i) {
+  if (len == 0) { return rows[i]; }
+  return data + i * len;
+}
+
+/*
+ * @brief      行の MJD
+ *
+ * @param[in]  行 (unsigned int)
+ * @return     MJD (unsigned int)
+ */
+unsigned int Eop::row_mjd(unsigned int i) {
+  return static_cast<unsigned int>(field(row(i), kColMjd, 8));
+}
+
+/*
+ * @brief      行内の数値項目
+ *             * 行末・ファイル末を越えて読まない
+ *             * 空欄の場合は 0.0
+ *
+ * @param[in]  行の先頭 (const char*)
+ * @param[in]  桁位置 (size_t)
+ * @param[in]  桁数 (size_t)
+ * @return     値 (double)
+ */
+double Eop::field(const char* r, size_t pos, size_t n) {
+  char   buf[16] = {};
+  size_t i;
+
+  for (i = 0; i < pos && r + i < data + size; ++i) {
+    if (r[i] == '\n') { return 0.0; }
+  }
+  for (i = 0; i < n && r + pos + i < data + size; ++i) {
+    if (r[pos + i] == '\n') { break; }
+    buf[i] = r[pos + i];
+  }
+
+  return std::strtod(buf, nullptr);
+}
+
+}  // namespace iss_sgp4_json
@@ -12,21 +12,37 @@
 
 namespace iss_sgp4_json {
 
+// EOP データ構造体
+struct EopRec {
+  double pm_x;  // 極運動(x)
+  double pm_y;  // 極運動(y)
+  double dut1;  // DUT1
+  double lod;   // LOD
+};
+
 class Eop {
+  const char*              data;    // EOP ファイル(メモリマップ)
+  size_t                   size;    // EOP ファイルサイズ
+  size_t                   len;     // 1行の長さ(改行含む; 固定長の場合)
+  unsigned int             n_rec;   // 行数
+  unsigned int             mjd_s;   // 先頭行の MJD
+  std::vector<const char*> rows;    // 各行の先頭(固定長でない場合のみ)
 
 public:
-  Eop(struct timespec);  // コンストラクタ
-  std::string eop;       // EOP データ
-  double pm_x;           // 極運動(x)
-  double pm_y;           // 極運動(y)
-  double dut1;           // DUT1
-  double lod;            // LOD
+  Eop(std::string = "eop.txt");  // コンストラクタ
+  ~Eop();                        // デストラクタ
+  Eop(const Eop&) = delete;
+  Eop& operator=(const Eop&) = delete;
+  EopRec get_eop(struct timespec);  // EOP データ取得
+  bool has_eop(struct timespec);    // EOP データの有無
 
 private:
-  std::string get_eop(struct timespec);  // EOP データ取得
+  bool find(unsigned int, unsigned int&);     // 行位置の特定
+  const char* row(unsigned int);              // 行の先頭
+  unsigned int row_mjd(unsigned int);         // 行の MJD
+  double field(const char*, size_t, size_t);  // 行内の数値項目
 };
 
 }  // namespace iss_sgp4_json
 
 #endif
-
@@ -0,0 +1,339 @@
+#include "ephem.hpp"
+
+#include "prof.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+
+namespace iss_sgp4_json {
+
+// 定数
+static constexpr char         kMagic[8] = {'I', 'S', 'S', 'E', 'P', 'H', '0', '1'};
+                                                     // 暦ファイルの識別子
+static constexpr double       kPi     = 3.14159265358979323846;  // 円周率
+static constexpr double       kMinSeg = 1.0;         // セグメント長の下限(秒)
+static constexpr double       kVelTol = 1.0e-3;      // 速度の誤差の上限 / 位置の誤差の上限(1/s)
+static constexpr unsigned int kChk    = 2 * kChebN;  // 検証点の数(セグメント毎; 両端含め +1)
+
+/*
+ * @brief      Chebyshev 多項式の値 T_0(x) .. T_{kChebDeg}(x)
+ *
+ * @param[in]  x (double; -1 .. 1)
+ * @param[out] T_j(x) (double[kChebN])
+ */
+static inline void cheb_t(double x, double* t) {
+  unsigned int j;
+
+  t[0] = 1.0;
+  t[1] = x;
+  for (j = 2; j < kChebN; ++j) { t[j] = 2.0 * x * t[j - 1] - t[j - 2]; }
+}
+
+/*
+ * @brief      係数による位置・速度の計算（1セグメント分）
+ *
+ * @param[in]  係数 (const double*; x, y, z, vx, vy, vz の順に kChebN 個ずつ)
+ * @param[in]  x (double; -1 .. 1)
+ * @return     位置・速度 (PvTeme)
+ */
+static PvTeme cheb_eval(const double* c, double x) {
+  double       t[kChebN];
+  double       v[6] = {0.0, 0.0, 0.0, 0.0, 0.0, 0.0};
+  unsigned int i;
+  unsigned int j;
+
+  cheb_t(x, t);
+  for (i = 0; i < 6; ++i) {
+    for (j = 0; j < kChebN; ++j) { v[i] += c[i * kChebN + j] * t[j]; }
+  }
+
+  return {{v[0], v[1], v[2]}, {v[3], v[4], v[5]}};
+}
+
+/*
+ * @brief      コンストラクタ
+ */
+Ephem::Ephem() : ut1_s({0, 0}), t_end(0.0), tol(0.0) {}
+
+/*
+ * @brief      暦の生成
+ *             * 計算開始から指定秒数分の SGP4 の位置・速度(TEME)を、
+ *               座標毎に区分的な Chebyshev 多項式(kChebDeg 次)で近似する
+ *             * TLE が切り替わる日時で区間を分け（区間をまたぐと不連続の
+ *               ため）、区間毎に誤差が上限以内となるまでセグメント数を
+ *               倍にする
+ *             * 誤差は、位置が指定の上限(km)、速度がその kVelTol 倍(km/s)
+ *               以内（各セグメントの検証点で SGP4 と比較）
+ *             * 次の区間の開始 UT1 は切り替え日時(秒)そのものとする（経過秒
+ *               から求め直すと丸めで切り替え前に戻り、同じ区間を繰り返す
+ *               ため）
+ *
+ * @param[ref] SGP4 (Sgp4)
+ * @param[ref] TLE (Tle)
+ * @param[in]  UT1(計算開始) (timespec)
+ * @param[in]  秒数 (double)
+ * @param[in]  誤差の上限(位置; km) (double)
+ * @return     成否(セグメント長 kMinSeg 秒でも上限を越えれば false) (bool)
+ */
+bool Ephem::fit(
+    Sgp4& o_s, Tle& o_t, struct timespec ut1_s, double sec, double tol) {
+  double              t;    // 区間の開始(経過秒)
+  double              t_e;  // 区間の終了(経過秒)
+  unsigned int        n;    // セグメント数
+  struct timespec     ut1;
+  struct timespec     nxt;  // 次の TLE 切り替え日時
+  std::vector<double> c;    // 係数(区間分)
+
+  try {
+    this->ut1_s = ut1_s;
+    this->tol   = tol;
+    t_end = sec;
+    spans.clear();
+    coef.clear();
+
+    ut1 = ut1_s;
+    for (t = 0.0; t < sec; t = t_e) {
+      nxt = o_t.next_epoch(ut1);
+      t_e = std::min(sec, static_cast<double>(nxt.tv_sec - ut1_s.tv_sec)
+                        - ut1_s.tv_nsec * 1.0e-9);
+      if (!(t_e > t)) {
+        throw std::logic_error("Ephem::fit: span does not advance");
+      }
+      Satellite& sat = o_s.get_sat(o_t.get_tle(ut1));
+      for (n = 1; !fit_span(o_s, sat, t, t_e, n, c); n *= 2) {
+        if ((t_e - t) / n < kMinSeg) { return false; }
+      }
+      spans.push_back({t, t_e, (t_e - t) / n, n, segments()});
+      coef.insert(coef.end(), c.begin(), c.end());
+      ut1 = {nxt.tv_sec, 0};  // TLE は秒単位で切り替わる
+    }
+  } catch (...) {
+    throw;
+  }
+
+  return true;
+}
+
+/*
+ * @brief      位置・速度(経過秒指定)
+ *             * 区間は二分探索（区間数は TLE の切り替え数程度）、
+ *               セグメントは区間内の経過秒から直接求める
+ *
+ * @param[in]  基準 UT1 からの経過秒 (double; 0 .. get_end())
+ * @return     位置・速度(TEME) (PvTeme)
+ */
+PvTeme Ephem::eval(double t) const {
+  std::vector<EphemSpan>::const_iterator it;
+  unsigned int i;
+  double       a;
+
+  if (!(t >= 0.0 && t <= t_end) || spans.empty()) {
+    throw std::out_of_range("Ephem::eval: time out of range");
+  }
+  it = std::upper_bound(spans.cbegin(), spans.cend(), t,
+      [](double t, const EphemSpan& s) { return t < s.t_s; });
+  --it;
+  i = std::min(static_cast<unsigned int>((t - it->t_s) / it->len),
+               it->n_seg - 1);
+  a = it->t_s + i * it->len;
+
+  return cheb_eval(&coef[(it->off + i) * 6 * kChebN],
+                   2.0 * (t - a) / it->len - 1.0);
+}
+
+/*
+ * @brief      位置・速度(UT1 指定)
+ *
+ * @param[in]  UT1 (timespec)
+ * @return     位置・速度(TEME) (PvTeme)
+ */
+PvTeme Ephem::eval(struct timespec ut1) const {
+  return eval((ut1.tv_sec - ut1_s.tv_sec)
+            + (ut1.tv_nsec - ut1_s.tv_nsec) * 1.0e-9);
+}
+
+/*
+ * @brief      暦ファイル書き込み
+ *             * バイナリ形式（実行環境のバイト順）
+ *               識別子(8), 次数(u32), 区間数(u32), 基準 UT1 秒(i64),
+ *               ナノ秒(i64), 終了(f64), 誤差の上限(f64),
+ *               区間 * (開始(f64), 終了(f64), セグメント長(f64),
+ *                       セグメント数(u32), 通し番号(u32)),
+ *               係数(f64; セグメント数 * 6 * kChebN)
+ *
+ * @param[in]  ファイル名 (string)
+ * @return     成否 (bool)
+ */
+bool Ephem::save(std::string f) const {
+  std::FILE* fp;
+  uint32_t   u[2] = {kChebDeg, static_cast<uint32_t>(spans.size())};
+  int64_t    s[2] = {ut1_s.tv_sec, ut1_s.tv_nsec};
+  double     d[2] = {t_end, tol};
+  bool       ok;
+
+  fp = std::fopen(f.c_str(), "wb");
+  if (fp == nullptr) { return false; }
+  ok = std::fwrite(kMagic, sizeof(kMagic), 1, fp) == 1
+    && std::fwrite(u, sizeof(u), 1, fp) == 1
+    && std::fwrite(s, sizeof(s), 1, fp) == 1
+    && std::fwrite(d, sizeof(d), 1, fp) == 1;
+  for (const EphemSpan& sp : spans) {
+    double   sd[3] = {sp.t_s, sp.t_e, sp.len};
+    uint32_t su[2] = {sp.n_seg, sp.off};
+    ok = ok && std::fwrite(sd, sizeof(sd), 1, fp) == 1
+            && std::fwrite(su, sizeof(su), 1, fp) == 1;
+  }
+  ok = ok && std::fwrite(coef.data(), sizeof(double), coef.size(), fp)
+             == coef.size();
+
+  return std::fclose(fp) == 0 && ok;
+}
+
+/*
+ * @brief      暦ファイル読み込み
+ *             * 形式は save を参照（識別子・次数・区間の整合性を確認）
+ *
+ * @param[in]  ファイル名 (string)
+ * @return     成否 (bool)
+ */
+bool Ephem::load(std::string f) {
+  std::FILE* fp;
+  char       m[sizeof(kMagic)];
+  uint32_t   u[2];
+  int64_t    s[2];
+  double     d[2];
+  size_t     n_seg = 0;
+  bool       ok;
+
+  spans.clear();
+  coef.clear();
+  fp = std::fopen(f.c_str(), "rb");
+  if (fp == nullptr) { return false; }
+  ok = std::fread(m, sizeof(m), 1, fp) == 1
+    && std::memcmp(m, kMagic, sizeof(m)) == 0
+    && std::fread(u, sizeof(u), 1, fp) == 1 && u[0] == kChebDeg
+    && std::fread(s, sizeof(s), 1, fp) == 1
+    && std::fread(d, sizeof(d), 1, fp) == 1;
+  if (ok) {
+    ut1_s = {static_cast<time_t>(s[0]), static_cast<long>(s[1])};
+    t_end = d[0];
+    tol   = d[1];
+  }
+  while (ok && spans.size() < u[1]) {
+    double   sd[3];
+    uint32_t su[2];
+    ok = std::fread(sd, sizeof(sd), 1, fp) == 1
+      && std::fread(su, sizeof(su), 1, fp) == 1
+      && su[0] > 0 && su[1] == n_seg;
+    if (ok) {
+      spans.push_back({sd[0], sd[1], sd[2], su[0], su[1]});
+      n_seg += su[0];
+    }
+  }
+  if (ok) {
+    coef.resize(n_seg * 6 * kChebN);
+    ok = std::fread(coef.data(), sizeof(double), coef.size(), fp)
+         == coef.size();
+  }
+  std::fclose(fp);
+  if (!ok) {
+    spans.clear();
+    coef.clear();
+  }
+
+  return ok;
+}
+
+/********************************************
+ **** 以下、 private function/procedures ****
+ ********************************************/
+
+/*
+ * @brief      区間の当てはめ
+ *             * 区間を n 個のセグメントに等分し、セグメント毎に
+ *               Chebyshev 点(第1種; kChebN 個)での SGP4 の値から係数を求める
+ *             * 各セグメントの両端を含む等間隔の検証点(kChk + 1 個)で
+ *               SGP4 と比較し、誤差が上限以内か確認する
+ *
+ * @param[ref] SGP4 (Sgp4)
+ * @param[ref] 衛星情報 (Satellite)
+ * @param[in]  区間の開始(経過秒) (double)
+ * @param[in]  区間の終了(経過秒) (double)
+ * @param[in]  セグメント数 (unsigned int)
+ * @param[out] 係数(区間分) (vector<double>)
+ * @return     誤差が上限以内か (bool)
+ */
+bool Ephem::fit_span(
+    Sgp4& o_s, Satellite& sat, double t_s, double t_e, unsigned int n,
+    std::vector<double>& c) {
+  double       len = (t_e - t_s) / n;  // セグメント長
+  double       f[kChebN][6];           // Chebyshev 点での値
+  double       tj[kChebN];
+  double       a;                      // セグメントの開始
+  double       x;
+  double       e;
+  unsigned int i;
+  unsigned int j;
+  unsigned int k;
+  unsigned int m;
+  double*      cs;
+  PvTeme       p;
+  PvTeme       q;
+
+  try {
+    ProfTimer pt(Stage::kSgp4, n * (kChebN + kChk + 1));
+
+    c.assign(n * 6 * kChebN, 0.0);
+    for (i = 0; i < n; ++i) {
+      a  = t_s + i * len;
+      cs = &c[i * 6 * kChebN];
+
+      // Chebyshev 点での値
+      for (k = 0; k < kChebN; ++k) {
+        x = std::cos(kPi * (k + 0.5) / kChebN);
+        p = o_s.propagate(sat, ts_add(ut1_s, a + 0.5 * len * (x + 1.0)));
+        f[k][0] = p.r.x;
+        f[k][1] = p.r.y;
+        f[k][2] = p.r.z;
+        f[k][3] = p.v.x;
+        f[k][4] = p.v.y;
+        f[k][5] = p.v.z;
+      }
+
+      // 係数（c_0 は 1/2 倍したものを保持）
+      for (k = 0; k < kChebN; ++k) {
+        cheb_t(std::cos(kPi * (k + 0.5) / kChebN), tj);
+        for (j = 0; j < kChebN; ++j) {
+          for (m = 0; m < 6; ++m) {
+            cs[m * kChebN + j] += f[k][m] * tj[j] * 2.0 / kChebN;
+          }
+        }
+      }
+      for (m = 0; m < 6; ++m) { cs[m * kChebN] *= 0.5; }
+
+      // 検証
+      for (k = 0; k <= kChk; ++k) {
+        p = o_s.propagate(sat, ts_add(ut1_s, a + len * k / kChk));
+        q = cheb_eval(cs, 2.0 * k / kChk - 1.0);
+        e = std::sqrt((p.r.x - q.r.x) * (p.r.x - q.r.x)
+                    + (p.r.y - q.r.y) * (p.r.y - q.r.y)
+                    + (p.r.z - q.r.z) * (p.r.z - q.r.z));
+        if (e > tol) { return false; }
+        e = std::sqrt((p.v.x - q.v.x) * (p.v.x - q.v.x)
+                    + (p.v.y - q.v.y) * (p.v.y - q.v.y)
+                    + (p.v.z - q.v.z) * (p.v.z - q.v.z));
+        if (e > tol * kVelTol) { return false; }
+      }
+    }
+  } catch (...) {
+    throw;
+  }
+
+  return true;
+}
+
+}  // namespace iss_sgp4_json
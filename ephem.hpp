@@ -0,0 +1,57 @@
+#ifndef ISS_SGP4_JSON_EPHEM_HPP_
+#define ISS_SGP4_JSON_EPHEM_HPP_
+
+#include "sgp4.hpp"
+#include "time.hpp"
+#include "tle.hpp"
+
+#include <ctime>
+#include <string>
+#include <vector>
+
+namespace iss_sgp4_json {
+
+static constexpr unsigned int kChebDeg = 12;  // Chebyshev 多項式の次数
+static constexpr unsigned int kChebN   = kChebDeg + 1;  // 係数の数(1座標分)
+
+// 暦の区間（TLE が同じ範囲）
+// * 区間内は同じ長さのセグメントに等分する
+struct EphemSpan {
+  double       t_s;    // 開始(基準 UT1 からの経過秒)
+  double       t_e;    // 終了(基準 UT1 からの経過秒)
+  double       len;    // セグメント長(秒)
+  unsigned int n_seg;  // セグメント数
+  unsigned int off;    // 先頭セグメントの通し番号
+};
+
+class Ephem {
+  struct timespec        ut1_s;  // 基準 UT1(計算開始)
+  double                 t_end;  // 終了(基準 UT1 からの経過秒)
+  double                 tol;    // 誤差の上限(位置; km)
+  std::vector<EphemSpan> spans;  // 区間一覧（時刻順）
+  std::vector<double>    coef;   // 係数（セグメント毎に x, y, z, vx, vy, vz の順
+                                 //       に kChebN 個ずつ）
+
+public:
+  Ephem();                                  // コンストラクタ
+  bool fit(Sgp4&, Tle&, struct timespec, double, double);
+                                            // 暦の生成
+  PvTeme eval(double) const;                // 位置・速度(経過秒指定)
+  PvTeme eval(struct timespec) const;       // 位置・速度(UT1 指定)
+  bool save(std::string) const;             // 暦ファイル書き込み
+  bool load(std::string);                   // 暦ファイル読み込み
+  struct timespec get_ut1() const { return ut1_s; }  // 基準 UT1
+  double get_end() const { return t_end; }  // 終了(経過秒)
+  double get_tol() const { return tol; }    // 誤差の上限(位置; km)
+  unsigned int segments() const { return coef.size() / (kChebN * 6); }
+                                            // セグメント数
+
+private:
+  bool fit_span(
+      Sgp4&, Satellite&, double, double, unsigned int, std::vector<double>&);
+                                            // 区間の当てはめ
+};
+
+}  // namespace iss_sgp4_json
+
+#endif
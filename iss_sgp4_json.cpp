@@ -7,160 +7,681 @@
 
   Copyright(C) 2021 mk-mode.com All Rights Reserved.
   ---
-  引数 : JST（日本標準時）
+  引数 : [オプション] JST（日本標準時）
            書式：最大23桁の数字
                  （先頭から、西暦年(4), 月(2), 日(2), 時(2), 分(2), 秒(2),
                              1秒未満(9)（小数点以下9桁（ナノ秒）まで））
                  無指定なら現在(システム日時)と判断。
+         オプション:
+           -d, --days DAYS    計算期間(日; 小数可; 既定値: 2)
+           -s, --step SEC     計算間隔(秒; 1秒未満可; 既定値: 10)
+           -o, --output FILE  書き込みファイル("-" なら標準出力; 既定値: iss.json)
+           -c, --stdout       標準出力へ書き込み(-o - と同じ)
+           -t, --threads N    計算スレッド数(既定値: 1)
+           -C, --catalog FILE カタログ(複数衛星の TLE)ファイル
+                              (指定すると全衛星を計算し、衛星毎に
+                               "衛星番号.json" へ書き込み)
+           -D, --dir DIR      カタログ指定時の書き込みディレクトリ(既定値: .)
+           -S, --scalar       カタログ指定時、近地球の衛星もまとめずに
+                              1衛星ずつ計算
+           -e, --ephem FILE   JSON の代わりに、計算期間の位置・速度(TEME)を
+                              区分的 Chebyshev 多項式で近似した暦ファイル
+                              (バイナリ)を書き込み
+           -H, --hermite SEC  SGP4 を最大 SEC 秒間隔の節点でのみ計算し、
+                              その間の計算時刻は3次 Hermite 補間
+           -a, --adaptive KM  前後の出力からの線形補間(緯度・経度・高度)で
+                              誤差が KM 以内となる計算時刻を出力しない
+           -A, --accuracy     --hermite・--adaptive 指定時、全件 SGP4 との
+                              差を標準エラー出力へ表示
+           -T, --tol KM       暦・Hermite 補間の位置の誤差の上限(km; 暦の
+                              速度は 1/1000 倍の km/s; Hermite 補間の速度は
+                              対象外; 既定値: 0.001)
+           -g, --ground       速度(ECEF; vx_ecef, vy_ecef, vz_ecef)・対地速度
+                              (ground_speed)・方位(heading)も出力
+           -p, --profile      処理区間毎の所要時間を標準エラー出力へ表示
+           -h, --help         使用方法の表示
   ---
   MEMO:
     TEME: True Equator, Mean Equinox; 真赤道面平均春分点
      PEF: Pseudo Earth Fixed; 擬地球固定座標系
     ECEF: Earth Centered, Earth Fixed; 地球中心・地球固定直交座標系
 ***********************************************************/
+#include "batch.hpp"
 #include "blh.hpp"
+#include "catalog.hpp"
+#include "dat.hpp"
 #include "eop.hpp"
+#include "ephem.hpp"
+#include "json.hpp"
+#include "pool.hpp"
+#include "prof.hpp"
 #include "sgp4.hpp"
 #include "time.hpp"
 #include "tle.hpp"
 
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
 #include <cstdlib>   // for EXIT_XXXX
 #include <ctime>
+#include <getopt.h>
 #include <iomanip>
 #include <iostream>
+#include <mutex>
 #include <string>
 #include <vector>
 
 namespace iss_sgp4_json {
 
-static constexpr char         kFOut[] = "iss.json";  // 書き込みファイル
-static constexpr unsigned int kDay    = 2;           // 計算日数(日)
-static constexpr unsigned int kSec    = 10;          // 計算間隔(秒)
-static constexpr double       kSecD   = 86400.0;     // 秒数(1日分)
+static constexpr char      kFOut[] = "iss.json";        // 書き込みファイル(既定値)
+static constexpr double    kDay    = 2.0;               // 計算日数(日; 既定値)
+static constexpr double    kSec    = 10.0;              // 計算間隔(秒; 既定値)
+static constexpr double    kSecD   = 86400.0;           // 秒数(1日分)
+static constexpr double    kDayMax = 36525.0;           // 計算日数・間隔の上限(日; ナノ秒で long long に収まる範囲)
+static constexpr long      kThrMax = 256;               // 計算スレッド数の上限
+static constexpr double    kTol    = 1.0e-3;            // 暦の誤差の上限(km; 既定値)
+
+// オプション構造体
+struct Opt {
+  double      day  = kDay;   // 計算日数(日)
+  double      sec  = kSec;   // 計算間隔(秒)
+  std::string f    = kFOut;  // 書き込みファイル("-": 標準出力)
+  std::string jst  = "";     // JST 文字列(無指定なら現在日時)
+  unsigned    thr  = 1;      // 計算スレッド数
+  std::string cat  = "";     // カタログファイル(指定時はカタログモード)
+  std::string dir  = ".";    // 書き込みディレクトリ(カタログモード)
+  bool        scl  = false;  // 近地球の衛星も1衛星ずつ計算(カタログモード)
+  bool        prof = false;  // 処理区間毎の所要時間の表示
+  std::string eph  = "";     // 暦ファイル(指定時は暦モード)
+  double      tol  = kTol;   // 暦・Hermite 補間の誤差の上限(km)
+  double      herm = 0.0;    // Hermite 補間の節点の間隔の上限(秒; 0: 補間しない)
+  double      adp  = 0.0;    // 間引きの誤差の上限(km; 0: 間引かない)
+  bool        acc  = false;  // 補間・間引きの誤差の表示
+  bool        gnd  = false;  // 速度(ECEF)・対地速度・方位の出力
+};
+
+/*
+ * @brief      使用方法の表示
+ *
+ * @param[in]  プログラム名 (const char*)
+ */
+static void usage(const char* prog) {
+  std::cout << "Usage: " << prog << " [OPTION]... [YYYYMMDDHHMMSSMMMMMMMMM]\n"
+            << "  -d, --days DAYS    calculation period in days (default: 2)\n"
+            << "  -s, --step SEC     calculation step in seconds (default: 10)\n"
+            << "  -o, --output FILE  output file, \"-\" for stdout"
+            << " (default: iss.json)\n"
+            << "  -c, --stdout       write to stdout (same as -o -)\n"
+            << "  -t, --threads N    number of calculation threads"
+            << " (default: 1)\n"
+            << "  -C, --catalog FILE propagate every object of a multi-object"
+            << " TLE file,\n"
+            << "                     writing one SATNUM.json per object\n"
+            << "  -D, --dir DIR      output directory for --catalog"
+            << " (default: .)\n"
+            << "  -S, --scalar       with --catalog, propagate near-earth"
+            << " objects one by one\n"
+            << "                     instead of in SIMD lanes\n"
+            << "  -e, --ephem FILE   write a Chebyshev ephemeris (binary)"
+            << " instead of JSON\n"
+            << "  -H, --hermite SEC  run SGP4 only on nodes at most SEC apart"
+            << " and fill the\n"
+            << "                     steps between by cubic Hermite"
+            << " interpolation\n"
+            << "  -a, --adaptive KM  omit steps that linear interpolation"
+            << " (lat, lon, height)\n"
+            << "                     between the kept steps reproduces within"
+            << " KM\n"
+            << "  -A, --accuracy     with --hermite or --adaptive, print the"
+            << " error against\n"
+            << "                     full propagation to stderr\n"
+            << "  -T, --tol KM       position error bound in km for --ephem"
+            << " and --hermite,\n"
+            << "                     ephemeris velocity bound is 1/1000 of it"
+            << " in km/s,\n"
+            << "                     interpolated --hermite velocity is not"
+            << " bounded\n"
+            << "                     (default: 0.001)\n"
+            << "  -g, --ground       also write ECEF velocity (vx_ecef,"
+            << " vy_ecef, vz_ecef),\n"
+            << "                     ground speed and heading\n"
+            << "  -p, --profile      print per-stage timings to stderr\n"
+            << "  -h, --help         show this help" << std::endl;
+}
+
+/*
+ * @brief      実数オプションの解析
+ *
+ * @param[in]  オプション文字列 (const char*)
+ * @param[out] 値 (double)
+ * @return     成否(正の有限値なら true) (bool)
+ */
+static bool parse_pos(const char* str, double& v) {
+  char* e;
+
+  v = std::strtod(str, &e);
+  return e != str && *e == '\0' && std::isfinite(v) && v > 0.0;
 }
 
+/*
+ * @brief      コマンドライン引数の解析
+ *
+ * @param[in]  引数の数 (int)
+ * @param[in]  引数 (char*[])
+ * @param[out] オプション (Opt)
+ * @return     0: 正常, 1: 終了(ヘルプ表示), -1: エラー (int)
+ */
+static int parse_opt(int argc, char* argv[], Opt& opt) {
+  static const struct option kLongOpts[] = {
+    {"days",   required_argument, nullptr, 'd'},
+    {"step",   required_argument, nullptr, 's'},
+    {"output", required_argument, nullptr, 'o'},
+    {"stdout", no_argument,       nullptr, 'c'},
+    {"threads", required_argument, nullptr, 't'},
+    {"catalog", required_argument, nullptr, 'C'},
+    {"dir",     required_argument, nullptr, 'D'},
+    {"scalar",  no_argument,       nullptr, 'S'},
+    {"ephem",   required_argument, nullptr, 'e'},
+    {"tol",     required_argument, nullptr, 'T'},
+    {"hermite", required_argument, nullptr, 'H'},
+    {"adaptive", required_argument, nullptr, 'a'},
+    {"accuracy", no_argument,      nullptr, 'A'},
+    {"ground",  no_argument,       nullptr, 'g'},
+    {"profile", no_argument,      nullptr, 'p'},
+    {"help",   no_argument,       nullptr, 'h'},
+    {nullptr,  0,                 nullptr,  0 }
+  };
+  int   c;
+  char* e;
+  long  n;
+  bool  out = false;  // 書き込みファイルの指定の有無
+
+  while ((c = getopt_long(argc, argv, "d:s:o:ct:C:D:Se:T:H:a:Agph", kLongOpts, nullptr)) != -1) {
+    switch (c) {
+      case 'd':
+        if (!parse_pos(optarg, opt.day) || opt.day > kDayMax) {
+          std::cerr << "[ERROR] Invalid days: " << optarg
+                    << " (max: " << kDayMax << " days)" << std::endl;
+          return -1;
+        }
+        break;
+      case 's':
+        if (!parse_pos(optarg, opt.sec) || opt.sec > kDayMax * kSecD) {
+          std::cerr << "[ERROR] Invalid step: " << optarg
+                    << " (max: " << kDayMax << " days)" << std::endl;
+          return -1;
+        }
+        break;
+      case 'o':
+        opt.f = optarg;
+        out   = true;
+        break;
+      case 'c':
+        opt.f = "-";
+        out   = true;
+        break;
+      case 't':
+        n = std::strtol(optarg, &e, 10);
+        if (e == optarg || *e != '\0' || n <= 0 || n > kThrMax) {
+          std::cerr << "[ERROR] Invalid threads: " << optarg << std::endl;
+          return -1;
+        }
+        opt.thr = n;
+        break;
+      case 'C':
+        opt.cat = optarg;
+        break;
+      case 'D':
+        opt.dir = optarg;
+        break;
+      case 'S':
+        opt.scl = true;
+        break;
+      case 'e':
+        opt.eph = optarg;
+        break;
+      case 'T':
+        if (!parse_pos(optarg, opt.tol)) {
+          std::cerr << "[ERROR] Invalid tolerance: " << optarg << std::endl;
+          return -1;
+        }
+        break;
+      case 'H':
+        if (!parse_pos(optarg, opt.herm)) {
+          std::cerr << "[ERROR] Invalid Hermite step: " << optarg << std::endl;
+          return -1;
+        }
+        break;
+      case 'a':
+        if (!parse_pos(optarg, opt.adp)) {
+          std::cerr << "[ERROR] Invalid adaptive tolerance: " << optarg
+                    << std::endl;
+          return -1;
+        }
+        break;
+      case 'A':
+        opt.acc = true;
+        break;
+      case 'g':
+        opt.gnd = true;
+        break;
+      case 'p':
+        opt.prof = true;
+        break;
+      case 'h':
+        usage(argv[0]);
+        return 1;
+      default:
+        usage(argv[0]);
+        return -1;
+    }
+  }
+  if (opt.herm > 0.0 && opt.adp > 0.0) {
+    std::cerr << "[ERROR] --hermite and --adaptive cannot be combined!"
+              << std::endl;
+    return -1;
+  }
+  if (opt.cat != "" && (out || opt.eph != "" || opt.herm > 0.0 ||
+                         opt.adp > 0.0 || opt.acc)) {
+    std::cerr << "[ERROR] --catalog cannot be combined with --output,"
+              << " --stdout, --ephem, --hermite, --adaptive or --accuracy!"
+              << std::endl;
+    return -1;
+  }
+  if (optind < argc) { opt.jst = argv[optind++]; }
+  if (optind < argc) {
+    usage(argv[0]);
+    return -1;
+  }
+
+  return 0;
+}
+
+/*
+ * @brief      カタログモード
+ *             * カタログの全衛星を指定の計算期間・間隔で計算し、衛星毎に
+ *               "衛星番号.json" へ書き込む
+ *             * 近地球の衛星は kLanes 個ずつまとめて Sgp4Simd で計算する
+ *               (深宇宙の衛星・--scalar 指定時は1衛星ずつ Sgp4 で計算)
+ *             * 衛星(のまとまり)をワークスティーリング方式のスレッドプール
+ *               で並列に計算する（深宇宙の衛星が他の衛星の計算を止めない
+ *               ように）
+ *             * SGP4 がエラーとなった衛星は書き込みファイルを削除して
+ *               次の衛星へ進む
+ *
+ * @param[in]  オプション (Opt)
+ * @param[ref] EOP (Eop)
+ * @param[ref] うるう秒 (Dat)
+ * @param[in]  JST(計算開始) (timespec)
+ * @param[in]  計算期間(ナノ秒) (long long)
+ * @param[in]  計算間隔(ナノ秒) (long long)
+ * @return     EXIT_SUCCESS: 全衛星成功, EXIT_FAILURE: 失敗あり (int)
+ */
+static int run_catalog(
+    const Opt& opt, Eop& o_e, Dat& o_d, struct timespec jst_s,
+    long long n_day, long long n_sec) {
+  long long                n_rec;  // 計算回数
+  unsigned int             n_err;  // 失敗した衛星数
+  std::vector<BatchDay>    days;   // 一括計算の日データ一覧
+  std::vector<BatchRun>    runs;   // 一括計算の区間一覧
+  std::vector<Satellite>   sats;   // 初期化済み衛星情報（カタログ順）
+  std::vector<std::string> msgs;   // 衛星毎のエラーメッセージ
+  std::vector<std::vector<size_t>> grps;  // 同時に計算する衛星のまとまり
+  std::mutex               mtx;    // メッセージ出力の排他制御
+  size_t                   i;
+
+  try {
+    // カタログ読み込み, 一括計算の区間一覧作成（TLE の切り替えなし）
+    Catalog o_c(opt.cat);
+    if (o_c.skipped() > 0) {
+      std::cerr << "[WARNING] " << o_c.skipped()
+                << " TLE(s) with unsupported format skipped." << std::endl;
+    }
+    n_rec = (n_day + n_sec - 1) / n_sec;
+    plan_batches(o_e, o_d, nullptr, jst_s, n_day, n_sec, days, runs);
+
+    // ワーカー毎の作業領域
+    Pool                     o_p(opt.thr);
+    std::vector<Sgp4>        sgp4s(o_p.size());
+    std::vector<std::vector<Trajectory>> trjs(
+        o_p.size(), std::vector<Trajectory>(kLanes));
+    std::vector<std::string> txts(o_p.size());
+    Sgp4Simd                 o_v(sgp4s[0].get_const());
+
+    // 衛星情報の初期化（全衛星）
+    sats.resize(o_c.size());
+    msgs.assign(o_c.size(), "");
+    o_p.run(o_c.size(), [&](unsigned int w, size_t i) {
+      try {
+        sats[i] = sgp4s[w].twoline2rv(o_c.get_recs()[i].tle);
+      } catch (const std::exception&) {
+        msgs[i] = std::to_string(o_c.get_recs()[i].satnum)
+                + " could not be propagated!";
+      }
+    });
+
+    // 近地球の衛星は kLanes 個ずつ、それ以外は1衛星ずつまとめる
+    auto is_simd = [&](size_t i) {
+      return !opt.scl && msgs[i] == "" && Sgp4Simd::is_near(sats[i]);
+    };
+    for (i = 0; i < o_c.size(); ++i) {
+      if (!is_simd(i)) {
+        grps.push_back({i});
+        continue;
+      }
+      if (grps.empty() || grps.back().size() >= kLanes
+       || !is_simd(grps.back()[0])) {
+        grps.push_back({});
+      }
+      grps.back().push_back(i);
+    }
+
+    n_err = 0;
+    o_p.run(grps.size(), [&](unsigned int w, size_t g) {
+      const std::vector<size_t>& grp = grps[g];
+      unsigned int      m = grp.size();
+      bool              simd = is_simd(grp[0]);
+      Json              o_js[kLanes];
+      std::string       fs[kLanes];
+      Trajectory*       ps[kLanes];
+      const Satellite*  ss[kLanes];
+      int               err[kLanes];
+      unsigned int      idx[kLanes];  // 計算中の衛星(grp の index)
+      unsigned int      n_act;        // 計算中の衛星数
+      unsigned int      l;
+      NearLanes         nl;
+
+      // 書き込みファイル open
+      for (l = 0; l < m; ++l) {
+        fs[l] = opt.dir + "/" + std::to_string(o_c.get_recs()[grp[l]].satnum)
+              + ".json";
+        if (msgs[grp[l]] == "" && !o_js[l].open(fs[l])) {
+          msgs[grp[l]] = fs[l] + " could not be opened!";
+        }
+        if (msgs[grp[l]] == "") { o_js[l].write_head(n_rec); }
+      }
+
+      // 区間毎に計算・書き込み
+      for (const BatchRun& r : runs) {
+        const BatchDay& d = days[r.day];
+        for (l = 0, n_act = 0; l < m; ++l) {
+          if (msgs[grp[l]] != "") { continue; }
+          idx[n_act] = l;
+          ps[n_act]  = &trjs[w][n_act];
+          ss[n_act]  = &sats[grp[l]];
+          ++n_act;
+        }
+        if (n_act == 0) { break; }
+        try {
+          Blh o_b(d.ut1, d.tai, d.pm_x, d.pm_y, d.lod);
+          if (simd) {
+            o_v.load(ss, n_act, nl);
+            propagate_lanes(o_v, nl, o_b, r.ut1, r.tai, n_sec * 1.0e-9, r.n,
+                            ps, err);
+          } else {
+            propagate_batch(sgp4s[w], sats[grp[0]], o_b, r.ut1, r.tai,
+                            n_sec * 1.0e-9, r.n, *ps[0]);
+            err[0] = sats[grp[0]].error;
+          }
+        } catch (const std::exception&) {
+          for (l = 0; l < n_act; ++l) {
+            msgs[grp[idx[l]]] = std::to_string(
+                o_c.get_recs()[grp[idx[l]]].satnum)
+                + " could not be propagated!";
+          }
+          break;
+        }
+        for (l = 0; l < n_act; ++l) {
+          if (err[l] != 0) {
+            msgs[grp[idx[l]]] = std::to_string(
+                o_c.get_recs()[grp[idx[l]]].satnum) + " SGP4 error "
+                + std::to_string(err[l]) + "!";
+            continue;
+          }
+          format_batch(d, r, *ps[l], n_sec, txts[w], opt.gnd);
+          o_js[idx[l]].write_recs(txts[w].data(), txts[w].size(), r.n);
+        }
+      }
+
+      // 書き込みファイル close（エラーの衛星は削除）
+      for (l = 0; l < m; ++l) {
+        if (msgs[grp[l]] == "") {
+          o_js[l].write_tail();
+          if (!o_js[l].close()) {
+            msgs[grp[l]] = fs[l] + " could not be written!";
+          }
+        }
+        if (msgs[grp[l]] != "") {
+          o_js[l].close();
+          std::remove(fs[l].c_str());
+          std::lock_guard<std::mutex> lk(mtx);
+          std::cerr << "[ERROR] " << msgs[grp[l]] << std::endl;
+          ++n_err;
+        }
+      }
+    });
+    if (opt.prof) { Prof::report(std::cerr, n_rec * o_c.size()); }
+  } catch (...) {
+    throw;
+  }
+
+  return n_err == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+/*
+ * @brief      暦モード
+ *             * 計算開始から計算期間分の位置・速度(TEME)を区分的 Chebyshev
+ *               多項式で近似し、暦ファイルへ書き込む（Ephem::load で
+ *               読み込み、Ephem::eval で任意時刻の値を取得）
+ *             * 基準時刻は計算開始の UT1（計算開始日の DUT1 で換算）
+ *
+ * @param[in]  オプション (Opt)
+ * @param[ref] EOP (Eop)
+ * @param[in]  JST(計算開始) (timespec)
+ * @param[in]  計算期間(ナノ秒) (long long)
+ * @return     EXIT_SUCCESS: 成功, EXIT_FAILURE: 失敗 (int)
+ */
+static int run_ephem(
+    const Opt& opt, Eop& o_e, struct timespec jst_s, long long n_day) {
+  struct timespec utc_s;  // UTC(計算開始)
+  struct timespec ut1_s;  // UT1(計算開始)
+
+  try {
+    Tle   o_t;
+    Sgp4  o_s;
+    Ephem o_x;
+
+    utc_s = jst2utc(jst_s);
+    ut1_s = utc2ut1(utc_s, o_e.get_eop(utc_s).dut1);
+    if (!o_x.fit(o_s, o_t, ut1_s, n_day * 1.0e-9, opt.tol)) {
+      std::cerr << "[ERROR] Ephemeris could not meet the tolerance!"
+                << std::endl;
+      return EXIT_FAILURE;
+    }
+    if (!o_x.save(opt.eph)) {
+      std::cerr << "[ERROR] " << opt.eph << " could not be written!"
+                << std::endl;
+      return EXIT_FAILURE;
+    }
+    if (opt.prof) { Prof::report(std::cerr, o_x.segments()); }
+  } catch (...) {
+    throw;
+  }
+
+  return EXIT_SUCCESS;
+}
+
+}  // namespace iss_sgp4_json
+
 int main(int argc, char* argv[]) {
   namespace ns = iss_sgp4_json;
-  std::string     f(ns::kFOut);  // 書き込みファイル
+  ns::Opt         opt;           // オプション
   std::string     tm_str;        // time string
   unsigned int    s_tm;          // size of time string
-  unsigned int    i;             // loop index
-  unsigned int    j;             // loop index
+  long long       n_day;         // 計算期間(ナノ秒)
+  long long       n_sec;         // 計算間隔(ナノ秒)
+  long long       n_rec;         // 計算回数
   int             s_nsec;        // size of nsec string
   int             ret;           // return of functions
   struct          tm t = {};     // for work
-  struct timespec jst;           // JST
-  struct timespec utc;           // UTC
-  struct timespec ut1;           // UT1
-  struct timespec tai;           // TAI
-  struct timespec jst_wk;        // JST(作業用)
-  struct timespec utc_wk;        // UTC(作業用)
-  struct timespec ut1_wk;        // UT1(作業用)
-  struct timespec tai_wk;        // TAI(作業用)
-  double          pm_x;          // 極運動(x)
-  double          pm_y;          // 極運動(y)
-  double          lod;           // LOD
-  std::string     lod_str;       // LOD 文字列
-  std::vector<std::string> tle;  // TLE
-  ns::Satellite   sat;           // 衛星情報
-  ns::PvTeme      teme;          // 位置・速度(TEME)
-  ns::PvBlh       blh;           // 位置・速度(BLH)
+  struct timespec now;           // システム日時
+  struct timespec jst_s;         // JST(計算開始)
+  std::vector<ns::BatchDay> days;  // 一括計算の日データ一覧
+  std::vector<ns::BatchRun> runs;  // 一括計算の区間一覧
+  ns::Interp      ip;            // Hermite 補間の設定
+  ns::InterpErr   i_err;         // 補間・間引きの誤差
+  std::vector<unsigned int> cnts;  // 出力件数(区間毎)
+  std::string     txt_a;         // 出力文字列(間引き時; 全区間分)
+  unsigned long   n_out = 0;     // 出力件数(間引き時)
 
   try {
+    // オプション解析
+    ret = ns::parse_opt(argc, argv, opt);
+    if (ret > 0) { return EXIT_SUCCESS; }
+    if (ret < 0) { return EXIT_FAILURE; }
+    n_day = std::llround(opt.day * ns::kSecD * 1.0e9);
+    n_sec = std::llround(opt.sec * 1.0e9);
+    ip.step = opt.herm;
+    ip.tol  = opt.tol;
+    ip.adp  = opt.adp;
+    if (n_sec <= 0 || n_day <= 0) {
+      std::cerr << "[ERROR] Days and step must be at least 1 nanosecond!"
+                << std::endl;
+      return EXIT_FAILURE;
+    }
+    n_rec = (n_day + n_sec - 1) / n_sec;
+    if (opt.prof) { ns::Prof::enable(); }
+
     // 現在日時(UT1) 取得
-    if (argc > 1) {
+    if (opt.jst != "") {
       // コマンドライン引数より取得
-      tm_str = argv[1];
+      tm_str = opt.jst;
       s_tm = tm_str.size();
       if (s_tm > 23) { 
-        std::cout << "[ERROR] Over 23-digits!" << std::endl;
+        std::cerr << "[ERROR] Over 23-digits!" << std::endl;
         return EXIT_FAILURE;
       }
       s_nsec = s_tm - 14;
       std::istringstream is(tm_str);
       is >> std::get_time(&t, "%Y%m%d%H%M%S");
-      jst.tv_sec  = mktime(&t);
-      jst.tv_nsec = 0;
+      jst_s = ns::dt2ts({static_cast<unsigned int>(t.tm_year + 1900),
+                         static_cast<unsigned int>(t.tm_mon + 1),
+                         static_cast<unsigned int>(t.tm_mday),
+                         static_cast<unsigned int>(t.tm_hour),
+                         static_cast<unsigned int>(t.tm_min),
+                         static_cast<double>(t.tm_sec)});
       if (s_tm > 14) {
-        jst.tv_nsec = std::stod(
+        jst_s.tv_nsec = std::stod(
             tm_str.substr(14, s_nsec) + std::string(9 - s_nsec, '0'));
       }
     } else {
       // 現在日時の取得
-      ret = std::timespec_get(&jst, TIME_UTC);
+      ret = std::timespec_get(&now, TIME_UTC);
       if (ret != 1) {
-        std::cout << "[ERROR] Could not get now time!" << std::endl;
+        std::cerr << "[ERROR] Could not get now time!" << std::endl;
         return EXIT_FAILURE;
       }
+      // システム日時（ローカル時刻）を JST とみなす
+      localtime_r(&now.tv_sec, &t);
+      jst_s = ns::dt2ts({static_cast<unsigned int>(t.tm_year + 1900),
+                         static_cast<unsigned int>(t.tm_mon + 1),
+                         static_cast<unsigned int>(t.tm_mday),
+                         static_cast<unsigned int>(t.tm_hour),
+                         static_cast<unsigned int>(t.tm_min),
+                         static_cast<double>(t.tm_sec)});
+      jst_s.tv_nsec = now.tv_nsec;
+    }
+
+    // EOP ファイルのマップ, うるう秒読み込み
+    ns::Eop o_e;
+    ns::Dat o_d;
+
+    // カタログモード
+    if (opt.cat != "") {
+      return ns::run_catalog(opt, o_e, o_d, jst_s, n_day, n_sec);
     }
 
+    // 暦モード
+    if (opt.eph != "") { return ns::run_ephem(opt, o_e, jst_s, n_day); }
+
+    // TLE 読み込み（全件）, 一括計算の区間一覧作成
+    ns::Tle o_t;
+    ns::plan_batches(o_e, o_d, &o_t, jst_s, n_day, n_sec, days, runs);
+
     // 書き込みファイル open
-    std::ofstream ofs(f);
-    if (!ofs) return 0;
-
-    // LOOP (日)
-    ofs << "{" << std::endl;
-    ofs << "  \"counts\": " << ns::kSecD * ns::kDay / ns::kSec
-        << "," << std::endl;
-    ofs << "  \"data\": [" << std::endl;
-    ofs << std::setprecision(12);
-    for (i = 0; i < ns::kDay; ++i) {
-      jst = ns::ts_add(jst, i * ns::kSecD);
-
-      // EOP データ取得
-      utc = ns::jst2utc(jst);
-      ns::Eop o_e(utc);
-      pm_x = o_e.pm_x;
-      pm_y = o_e.pm_y;
-      lod  = o_e.lod;
-      ut1  = ns::utc2ut1(utc);
-      tai  = ns::utc2tai(utc);
-
-      // LOOP (指定秒間隔)
-      for (j = 0; j < int(ns::kSecD); j += ns::kSec) {
-        jst_wk = ns::ts_add(jst, j);
-        utc_wk = ns::ts_add(utc, j);
-        ut1_wk = ns::ts_add(ut1, j);
-        tai_wk = ns::ts_add(tai, j);
-        //std::cout << ns::gen_time_str(jst_wk) << " JST" << std::endl;
-
-        // TLE 読み込み, gravconst 取得
-        ns::Tle o_t(ut1_wk);
-        tle = o_t.get_tle();
-
-        // ISS 初期位置・速度の取得
-        ns::Sgp4 o_s(ut1_wk, tle);
-        sat = o_s.twoline2rv();
-
-        // 指定 UT1 の ISS 位置・速度の取得
-        teme = o_s.propagate(sat);
-
-        // TEME -> BLH 変換
-        ns::Blh o_b(ut1_wk, tai_wk, pm_x, pm_y, lod);
-        blh = o_b.teme2blh(teme);
-
-        // 結果出力
-        ofs << "    {" << std::endl;
-        ofs << "      \"jst\": \"" << ns::gen_time_str(jst_wk) << "\","
-            << std::endl;
-        ofs << "      \"utc\": \"" << ns::gen_time_str(utc_wk) << "\","
-            << std::endl;
-        ofs << "      \"latitude\": "  << blh.r.b << "," << std::endl;
-        ofs << "      \"longitude\": " << blh.r.l << "," << std::endl;
-        ofs << "      \"height\": "    << blh.r.h << "," << std::endl;
-        ofs << "      \"velocity\": "  << blh.v   << std::endl;
-        if (i == 1 && j == int(ns::kSecD) - ns::kSec) {
-          ofs << "    }"  << std::endl;
-        } else {
-          ofs << "    }," << std::endl;
-        }
+    ns::Json o_j;
+    if (!o_j.open(opt.f)) {
+      std::cerr << "[ERROR] " << opt.f << " could not be opened!" << std::endl;
+      return EXIT_FAILURE;
+    }
+
+    // 区間毎の ISS 位置・速度(TEME) の取得, TEME -> BLH 変換, 結果出力
+    // * 間引き時は件数が計算後まで決まらないため、全区間の文字列をためて
+    //   からヘッダ部と共に書き込む
+    cnts.assign(runs.size(), 0);
+    if (opt.adp <= 0.0) { o_j.write_head(n_rec); }
+    ns::run_batches(days, runs, n_sec * 1.0e-9, opt.thr, ip,
+        [&](const ns::BatchRun& r, const ns::Trajectory& trj,
+            std::string& txt) {
+      // 文字列化（ワーカースレッド）
+      ns::format_batch(days[r.day], r, trj, n_sec, txt, opt.gnd);
+      cnts[&r - runs.data()] = trj.n;
+    },
+        [&](const ns::BatchRun& r, const std::string& txt) {
+      // 書き込み（区間の順）
+      ns::ProfTimer pt(ns::Stage::kJson, 0);
+      if (opt.adp <= 0.0) {
+        o_j.write_recs(txt.data(), txt.size(), cnts[&r - runs.data()]);
+        return;
+      }
+      if (!txt_a.empty() && !txt.empty()) { txt_a += ",\n"; }
+      txt_a += txt;
+      n_out += cnts[&r - runs.data()];
+    });
+    {
+      ns::ProfTimer pt(ns::Stage::kJson, 0);
+      if (opt.adp > 0.0) {
+        o_j.write_head(n_out);
+        o_j.write_recs(txt_a.data(), txt_a.size(), n_out);
+      }
+      o_j.write_tail();
+
+      // 書き込みファイル close
+      if (!o_j.close()) {
+        std::cerr << "[ERROR] " << opt.f << " could not be written!"
+                  << std::endl;
+        return EXIT_FAILURE;
       }
     }
-    ofs << "  ]" << std::endl;
-    ofs << "}" << std::endl;
+    if (opt.prof) { ns::Prof::report(std::cerr, n_rec); }
 
-    // 書き込みファイル close
-    ofs.close();
+    // Hermite 補間の誤差（全件 SGP4 との比較）
+    if (opt.acc && opt.herm > 0.0) {
+      ns::check_interp(days, runs, n_sec * 1.0e-9, ip, i_err);
+      std::cerr << std::scientific << std::setprecision(3)
+                << "[HERMITE] " << i_err.n << " interpolated points"
+                << ", position max " << i_err.r_max << " km, rms "
+                << (i_err.n > 0 ? std::sqrt(i_err.r_sq / i_err.n) : 0.0)
+                << " km, velocity max " << i_err.v_max << " km/s\n"
+                << "[HERMITE] latitude max " << i_err.b_max
+                << " deg, longitude max " << i_err.l_max
+                << " deg, height max " << i_err.h_max
+                << " km, speed max " << i_err.s_max << " km/s" << std::endl;
+    }
+
+    // 間引きの誤差（全件 SGP4 との比較）
+    if (opt.acc && opt.adp > 0.0) {
+      ns::check_adaptive(days, runs, n_sec * 1.0e-9, ip, i_err);
+      std::cerr << "[ADAPTIVE] " << n_out << " of " << n_rec
+                << " points written" << std::scientific
+                << std::setprecision(3) << ", position max " << i_err.r_max
+                << " km, rms "
+                << (i_err.n > 0 ? std::sqrt(i_err.r_sq / i_err.n) : 0.0)
+                << " km\n"
+                << "[ADAPTIVE] latitude max " << i_err.b_max
+                << " deg, longitude max " << i_err.l_max
+                << " deg, height max " << i_err.h_max << " km" << std::endl;
+    }
   } catch (...) {
       std::cerr << "EXCEPTION!" << std::endl;
       return EXIT_FAILURE;
@@ -0,0 +1,241 @@
+#include "json.hpp"
+
+#include <charconv>
+#include <cstring>
+
+namespace iss_sgp4_json {
+
+// 定数
+static constexpr size_t kBufSize = 1 << 20;   // 出力バッファサイズ
+static constexpr int    kPrec    = 12;        // 実数の有効桁数
+
+/*
+ * @brief      文字列(バッファへ書き込み)
+ *
+ * @param[out] バッファ (char*)
+ * @param[in]  文字列リテラル (const char[N])
+ * @return     書き込み後の位置 (char*)
+ */
+template <size_t N>
+static char* put_lit(char* p, const char (&s)[N]) {
+  std::memcpy(p, s, N - 1);
+  return p + N - 1;
+}
+
+/*
+ * @brief      実数(バッファへ書き込み; 有効桁数 12)
+ *             * std::ostream << std::setprecision(12) と同じ表記
+ *               (printf の %.12g と同じく正確に丸める)
+ *
+ * @param[out] バッファ (char*; 32 文字以上)
+ * @param[in]  値 (double)
+ * @return     書き込み後の位置 (char*)
+ */
+static char* put_dbl(char* p, double v) {
+  return std::to_chars(p, p + 32, v, std::chars_format::general, kPrec).ptr;
+}
+
+/*
+ * @brief      コンストラクタ
+ */
+Json::Json() {
+  fp     = nullptr;
+  is_std = false;
+  pos    = 0;
+  n_rec  = 0;
+  buf.resize(kBufSize);
+}
+
+/*
+ * @brief      デストラクタ
+ */
+Json::~Json() {
+  close();
+}
+
+/*
+ * @brief      書き込みファイル open
+ *
+ * @param[in]  ファイル名 (string; "-" なら標準出力)
+ * @return     成否 (bool)
+ */
+bool Json::open(std::string f) {
+  try {
+    close();
+    is_std = (f == "-");
+    fp = is_std ? stdout : std::fopen(f.c_str(), "w");
+  } catch (...) {
+    throw;
+  }
+
+  return fp != nullptr;
+}
+
+/*
+ * @brief      ヘッダ部書き込み
+ *
+ * @param[in]  レコード数 (unsigned long)
+ */
+void Json::write_head(unsigned long cnt) {
+  char  tmp[24];
+  char* p;
+
+  try {
+    p = std::to_chars(tmp, tmp + sizeof(tmp), cnt).ptr;
+    put("{\n");
+    put("  \"counts\": ");
+    put(tmp, p - tmp);
+    put(",\n");
+    put("  \"data\": [\n");
+    n_rec = 0;
+  } catch (...) {
+    throw;
+  }
+}
+
+/*
+ * @brief      レコード書き込み(生成済み文字列)
+ *             * put_rec で生成したレコードを ",\n" 区切りで連結した文字列
+ *               を書き込む（別スレッドで生成したレコードの書き込み用）
+ *
+ * @param[in]  文字列 (const char*)
+ * @param[in]  長さ (size_t)
+ * @param[in]  レコード数 (unsigned long)
+ */
+void Json::write_recs(const char* s, size_t n, unsigned long cnt) {
+  try {
+    if (cnt == 0) { return; }
+    if (n_rec > 0) { put(",\n"); }
+    put(s, n);
+    n_rec += cnt;
+  } catch (...) {
+    throw;
+  }
+}
+
+/*
+ * @brief      フッタ部書き込み
+ */
+void Json::write_tail() {
+  try {
+    if (n_rec > 0) { put("\n"); }
+    put("  ]\n");
+    put("}\n");
+  } catch (...) {
+    throw;
+  }
+}
+
+/*
+ * @brief      書き込みファイル close
+ *
+ * @return     成否 (bool)
+ */
+bool Json::close() {
+  bool ok = true;
+
+  if (fp == nullptr) { return ok; }
+  flush();
+  if (std::fflush(fp) != 0 || std::ferror(fp)) { ok = false; }
+  if (!is_std && std::fclose(fp) != 0) { ok = false; }
+  fp = nullptr;
+
+  return ok;
+}
+
+/*
+ * @brief      レコード文字列生成（バッファへ書き込み）
+ *             * 前後の区切り(",\n")は含まない
+ *             * 複数スレッドから呼び出し可
+ *
+ * @param[out] バッファ (char*; kRecMax 文字以上)
+ * @param[in]  JST (timespec)
+ * @param[in]  UTC (timespec)
+ * @param[in]  BLH (PvBlh)
+ * @param[in]  対地速度 (PvGnd*; nullptr なら出力しない)
+ * @return     文字列の長さ (size_t)
+ */
+size_t Json::put_rec(
+    char* buf, struct timespec jst, struct timespec utc, const PvBlh& blh,
+    const PvGnd* gnd) {
+  char* p = buf;
+
+  p = put_lit(p, "    {\n");
+  p = put_lit(p, "      \"jst\": \"");
+  p += put_time_str(jst, p);
+  p = put_lit(p, "\",\n");
+  p = put_lit(p, "      \"utc\": \"");
+  p += put_time_str(utc, p);
+  p = put_lit(p, "\",\n");
+  p = put_lit(p, "      \"latitude\": ");
+  p = put_dbl(p, blh.r.b);
+  p = put_lit(p, ",\n");
+  p = put_lit(p, "      \"longitude\": ");
+  p = put_dbl(p, blh.r.l);
+  p = put_lit(p, ",\n");
+  p = put_lit(p, "      \"height\": ");
+  p = put_dbl(p, blh.r.h);
+  p = put_lit(p, ",\n");
+  p = put_lit(p, "      \"velocity\": ");
+  p = put_dbl(p, blh.v);
+  if (gnd != nullptr) {
+    p = put_lit(p, ",\n");
+    p = put_lit(p, "      \"vx_ecef\": ");
+    p = put_dbl(p, gnd->v.x);
+    p = put_lit(p, ",\n");
+    p = put_lit(p, "      \"vy_ecef\": ");
+    p = put_dbl(p, gnd->v.y);
+    p = put_lit(p, ",\n");
+    p = put_lit(p, "      \"vz_ecef\": ");
+    p = put_dbl(p, gnd->v.z);
+    p = put_lit(p, ",\n");
+    p = put_lit(p, "      \"ground_speed\": ");
+    p = put_dbl(p, gnd->spd);
+    p = put_lit(p, ",\n");
+    p = put_lit(p, "      \"heading\": ");
+    p = put_dbl(p, gnd->hdg);
+  }
+  p = put_lit(p, "\n");
+  p = put_lit(p, "    }");
+
+  return p - buf;
+}
+
+/********************************************
+ **** 以下、 private function/procedures ****
+ ********************************************/
+
+/*
+ * @brief      文字列
+ *
+ * @param[in]  文字列 (const char*)
+ * @param[in]  長さ (size_t)
+ */
+void Json::put(const char* s, size_t n) {
+  if (pos + n > buf.size()) { flush(); }
+  if (n > buf.size()) {
+    std::fwrite(s, 1, n, fp);
+    return;
+  }
+  std::memcpy(buf.data() + pos, s, n);
+  pos += n;
+}
+
+/*
+ * @brief      文字列(NUL 終端)
+ *
+ * @param[in]  文字列 (const char*)
+ */
+void Json::put(const char* s) {
+  put(s, std::strlen(s));
+}
+
+/*
+ * @brief      出力バッファ書き出し
+ */
+void Json::flush() {
+  if (pos > 0 && fp != nullptr) { std::fwrite(buf.data(), 1, pos, fp); }
+  pos = 0;
+}
+
+}  // namespace iss_sgp4_json
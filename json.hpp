@@ -0,0 +1,47 @@
+#ifndef ISS_SGP4_JSON_JSON_HPP_
+#define ISS_SGP4_JSON_JSON_HPP_
+
+#include "blh.hpp"
+#include "time.hpp"
+
+#include <cstdio>
+#include <ctime>
+#include <string>
+#include <vector>
+
+namespace iss_sgp4_json {
+
+static constexpr size_t kRecMax = 512;  // 1レコード文字列の最大長(目安)
+
+class Json {
+  std::FILE*        fp;     // 書き込み先
+  bool              is_std; // 書き込み先が標準出力か
+  std::vector<char> buf;    // 出力バッファ
+  size_t            pos;    // 出力バッファの使用量
+  unsigned long     n_rec;  // 書き込み済みのレコード数
+
+public:
+  Json();                                // コンストラクタ
+  ~Json();                               // デストラクタ
+  Json(const Json&) = delete;
+  Json& operator=(const Json&) = delete;
+  bool open(std::string);                // 書き込みファイル open
+  void write_head(unsigned long);        // ヘッダ部書き込み
+  void write_recs(const char*, size_t, unsigned long);
+                                         // レコード書き込み(生成済み文字列)
+  void write_tail();                     // フッタ部書き込み
+  bool close();                          // 書き込みファイル close
+  static size_t put_rec(
+      char*, struct timespec, struct timespec, const PvBlh&,
+      const PvGnd* = nullptr);
+                                         // レコード文字列生成（バッファへ書き込み）
+
+private:
+  void put(const char*, size_t);         // 文字列
+  void put(const char*);                 // 文字列(NUL 終端)
+  void flush();                          // 出力バッファ書き出し
+};
+
+}  // namespace iss_sgp4_json
+
+#endif
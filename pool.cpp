@@ -0,0 +1,137 @@
+#include "pool.hpp"
+
+#include <exception>
+#include <thread>
+
+namespace iss_sgp4_json {
+
+/*
+ * @brief      コンストラクタ
+ *
+ * @param[in]  スレッド数 (unsigned int; 0 なら 1)
+ */
+Pool::Pool(unsigned int n_thr) {
+  unsigned int i;
+
+  this->n_thr = n_thr > 0 ? n_thr : 1;
+  for (i = 0; i < this->n_thr; ++i) {
+    qs.push_back(std::make_unique<PoolQueue>());
+  }
+}
+
+/*
+ * @brief      スレッド数
+ *
+ * @return     スレッド数 (unsigned int)
+ */
+unsigned int Pool::size() {
+  return n_thr;
+}
+
+/*
+ * @brief      全タスクの実行
+ *             * タスク 0 .. n-1 を実行し、全て終了するまで待つ
+ *             * 処理にはワーカー番号(0 .. size()-1)とタスクを渡す
+ *               (ワーカー毎の作業領域の選択用)
+ *             * 処理中に例外が発生した場合は残りのタスクを破棄し、
+ *               最初の例外を呼び出し元へ送出する
+ *
+ * @param[in]  タスク数 (size_t)
+ * @param[in]  処理 (function)
+ */
+void Pool::run(
+    size_t n, const std::function<void(unsigned int, size_t)>& f) {
+  std::vector<std::thread> thrs;  // ワーカースレッド
+  std::exception_ptr       err;   // 最初に発生した例外
+  std::mutex               mtx;   // 例外の排他制御
+  unsigned int             w;     // loop index(ワーカー)
+  size_t                   i;     // loop index(タスク)
+
+  try {
+    // タスクの配分（連続したまとまり毎）
+    for (w = 0; w < n_thr; ++w) {
+      for (i = n * w / n_thr; i < n * (w + 1) / n_thr; ++i) {
+        qs[w]->q.push_back(i);
+      }
+    }
+
+    // 単一スレッド
+    if (n_thr == 1) {
+      while (pop(0, i)) { f(0, i); }
+      return;
+    }
+
+    // ワーカースレッド
+    for (w = 0; w < n_thr; ++w) {
+      thrs.emplace_back([&, w]() {
+        size_t t;
+        while (pop(w, t) || steal(w, t)) {
+          try {
+            f(w, t);
+          } catch (...) {
+            std::lock_guard<std::mutex> lk(mtx);
+            if (!err) { err = std::current_exception(); }
+          }
+          {
+            std::lock_guard<std::mutex> lk(mtx);
+            if (err) { break; }
+          }
+        }
+      });
+    }
+    for (std::thread& t : thrs) { t.join(); }
+    if (err) { std::rethrow_exception(err); }
+  } catch (...) {
+    for (w = 0; w < n_thr; ++w) { qs[w]->q.clear(); }
+    throw;
+  }
+}
+
+/********************************************
+ **** 以下、 private function/procedures ****
+ ********************************************/
+
+/*
+ * @brief      タスク取得(自分のキュー)
+ *             * 末尾から取り出す
+ *
+ * @param[in]  ワーカー番号 (unsigned int)
+ * @param[out] タスク (size_t)
+ * @return     取得できたか (bool)
+ */
+bool Pool::pop(unsigned int w, size_t& t) {
+  std::lock_guard<std::mutex> lk(qs[w]->mtx);
+
+  if (qs[w]->q.empty()) { return false; }
+  t = qs[w]->q.back();
+  qs[w]->q.pop_back();
+
+  return true;
+}
+
+/*
+ * @brief      タスク取得(他のワーカーのキュー)
+ *             * 隣のワーカーから順に、先頭から盗む
+ *             * タスクは実行中に増えないため、全キューが空なら終了
+ *
+ * @param[in]  ワーカー番号 (unsigned int)
+ * @param[out] タスク (size_t)
+ * @return     取得できたか (bool)
+ */
+bool Pool::steal(unsigned int w, size_t& t) {
+  unsigned int i;
+  unsigned int v;
+
+  for (i = 1; i < n_thr; ++i) {
+    v = (w + i) % n_thr;
+    std::lock_guard<std::mutex> lk(qs[v]->mtx);
+    if (qs[v]->q.empty()) { continue; }
+    t = qs[v]->q.front();
+    qs[v]->q.pop_front();
+    return true;
+  }
+
+  return false;
+}
+
+}  // namespace iss_sgp4_json
@@ -0,0 +1,41 @@
+#ifndef ISS_SGP4_JSON_POOL_HPP_
+#define ISS_SGP4_JSON_POOL_HPP_
+
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace iss_sgp4_json {
+
+// ワーカー毎のタスクキュー
+struct PoolQueue {
+  std::mutex         mtx;  // 排他制御
+  std::deque<size_t> q;    // タスク(index)
+};
+
+// ワークスティーリング方式のスレッドプール
+// * タスクは各ワーカーのキューへ連続したまとまりで配分する
+// * ワーカーは自分のキューの末尾から取り出し、空になれば他のワーカーの
+//   キューの先頭から盗む（重いタスクを抱えたワーカーを待たない）
+class Pool {
+  unsigned int                            n_thr;  // スレッド数
+  std::vector<std::unique_ptr<PoolQueue>> qs;     // タスクキュー(ワーカー毎)
+
+public:
+  Pool(unsigned int);                   // コンストラクタ
+  unsigned int size();                  // スレッド数
+  void run(size_t,
+           const std::function<void(unsigned int, size_t)>&);
+                                        // 全タスクの実行
+
+private:
+  bool pop(unsigned int, size_t&);      // タスク取得(自分のキュー)
+  bool steal(unsigned int, size_t&);    // タスク取得(他のワーカーのキュー)
+};
+
+}  // namespace iss_sgp4_json
+
+#endif
@@ -0,0 +1,125 @@
+#include "prof.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+
+namespace iss_sgp4_json {
+
+static constexpr const char* kNames[] = {
+  "tle", "eop", "dat", "init", "sgp4", "hermite", "teme2blh", "json"
+};  // 計測区間名
+
+bool                                  Prof::on = false;
+std::chrono::steady_clock::time_point Prof::t_s;
+std::mutex                            Prof::mtx;
+ProfRec Prof::recs[static_cast<unsigned int>(Stage::kNum)];
+unsigned long                         Prof::kep_n   = 0;
+unsigned long                         Prof::kep_itr = 0;
+
+/*
+ * @brief      計測開始
+ *             * 以降の ProfTimer が計測を行う
+ */
+void Prof::enable() {
+  on  = true;
+  t_s = std::chrono::steady_clock::now();
+}
+
+/*
+ * @brief      所要時間の加算
+ *             * 複数スレッドから呼び出し可
+ *
+ * @param[in]  計測区間 (Stage)
+ * @param[in]  所要時間(秒) (double)
+ * @param[in]  処理件数 (unsigned long)
+ */
+void Prof::add(Stage st, double sec, unsigned long pts) {
+  ProfRec& rec = recs[static_cast<unsigned int>(st)];
+
+  try {
+    std::lock_guard<std::mutex> lk(mtx);
+    rec.secs.push_back(sec);
+    rec.pts += pts;
+  } catch (...) {
+    throw;
+  }
+}
+
+/*
+ * @brief      Kepler 方程式の反復回数の加算
+ *             * 複数スレッドから呼び出し可
+ *
+ * @param[in]  解いた回数 (unsigned long)
+ * @param[in]  反復回数の合計 (unsigned long)
+ */
+void Prof::add_kepler(unsigned long n, unsigned long itr) {
+  try {
+    std::lock_guard<std::mutex> lk(mtx);
+    kep_n   += n;
+    kep_itr += itr;
+  } catch (...) {
+    throw;
+  }
+}
+
+/*
+ * @brief      集計結果の出力
+ *             * 計測区間毎の合計・回数・平均・p50/p99・件数/秒
+ *             * 平均・p50/p99 は計測1回（ProfTimer 1個の区間）毎の値であり、
+ *               1回で複数件（最大 1 バッチ分）を処理する区間では 1 件毎では
+ *               なくバッチ毎の値になる（1 件当たりは件数/秒を参照）
+ *             * Kepler 方程式(1衛星ずつの SGP4)の平均反復回数
+ *
+ * @param[ref] 出力先 (ostream)
+ * @param[in]  全体の処理件数 (unsigned long)
+ */
+void Prof::report(std::ostream& os, unsigned long pts) {
+  double              sec;  // 全体の所要時間(秒)
+  double              sum;  // 計測区間の所要時間合計(秒)
+  std::vector<double> v;    // 所要時間(ソート済み)
+  unsigned int        i;    // loop index
+
+  try {
+    sec = std::chrono::duration<double>(
+        std::chrono::steady_clock::now() - t_s).count();
+    os << std::fixed
+       << "[PROFILE] total " << std::setprecision(6) << sec << " s, "
+       << pts << " points, " << std::setprecision(0)
+       << (sec > 0.0 ? pts / sec : 0.0) << " points/s\n"
+       << std::left  << std::setw(10) << "stage"
+       << std::right << std::setw(10) << "calls"
+       << std::setw(12) << "total(ms)"
+       << std::setw(15) << "mean/call(us)"
+       << std::setw(15) << "p50/call(us)"
+       << std::setw(15) << "p99/call(us)"
+       << std::setw(14) << "points/s" << "\n";
+    for (i = 0; i < static_cast<unsigned int>(Stage::kNum); ++i) {
+      v = recs[i].secs;
+      if (v.empty()) { continue; }
+      std::sort(v.begin(), v.end());
+      sum = 0.0;
+      for (double s : v) { sum += s; }
+      os << std::left  << std::setw(10) << kNames[i]
+         << std::right << std::setw(10) << v.size()
+         << std::setprecision(3)
+         << std::setw(12) << sum * 1.0e3
+         << std::setw(15) << sum / v.size() * 1.0e6
+         << std::setw(15) << v[(v.size() - 1) / 2] * 1.0e6
+         << std::setw(15)
+         << v[static_cast<size_t>(std::ceil(v.size() * 0.99)) - 1] * 1.0e6
+         << std::setprecision(0)
+         << std::setw(14) << (sum > 0.0 ? recs[i].pts / sum : 0.0) << "\n";
+    }
+    if (kep_n > 0) {
+      os << "[PROFILE] kepler " << kep_n << " solves, "
+         << std::setprecision(3) << static_cast<double>(kep_itr) / kep_n
+         << " iterations/solve\n";
+    }
+    os << std::flush;
+  } catch (...) {
+    throw;
+  }
+}
+
+}  // namespace iss_sgp4_json
@@ -0,0 +1,71 @@
+#ifndef ISS_SGP4_JSON_PROF_HPP_
+#define ISS_SGP4_JSON_PROF_HPP_
+
+#include <chrono>
+#include <mutex>
+#include <ostream>
+#include <vector>
+
+namespace iss_sgp4_json {
+
+// 計測区間
+enum class Stage : unsigned int {
+  kTle,   // TLE 読み込み
+  kEop,   // EOP 読み込み・検索
+  kDat,   // うるう秒読み込み・検索
+  kInit,  // SGP4 初期化(twoline2rv/sgp4init)
+  kSgp4,  // SGP4 伝播
+  kHerm,  // Hermite 補間
+  kBlh,   // TEME -> BLH 変換
+  kJson,  // JSON 書き込み
+  kNum    // 計測区間の数
+};
+
+// 計測区間毎の集計
+struct ProfRec {
+  std::vector<double> secs;     // 1回毎の所要時間(秒)
+  unsigned long       pts = 0;  // 処理件数
+};
+
+class Prof {
+  static bool                                           on;     // 計測有無
+  static std::chrono::steady_clock::time_point          t_s;    // 計測開始
+  static std::mutex                                     mtx;    // 集計の排他制御
+  static ProfRec recs[static_cast<unsigned int>(Stage::kNum)];  // 集計
+  static unsigned long                                  kep_n;    // Kepler 方程式を解いた回数
+  static unsigned long                                  kep_itr;  // Kepler 方程式の反復回数の合計
+
+public:
+  static bool enabled() { return on; }                  // 計測有無
+  static void enable();                                 // 計測開始
+  static void add(Stage, double, unsigned long);        // 所要時間の加算
+  static void add_kepler(unsigned long, unsigned long); // Kepler 方程式の反復回数の加算
+  static void report(std::ostream&, unsigned long);     // 集計結果の出力
+};
+
+// 区間計測（スコープの終わりまで）
+// * 計測しない場合は計測有無の判定のみ
+class ProfTimer {
+  Stage                                 st;   // 計測区間
+  unsigned long                         pts;  // 処理件数
+  bool                                  on;   // 計測有無
+  std::chrono::steady_clock::time_point t_s;  // 計測開始
+
+public:
+  explicit ProfTimer(Stage st, unsigned long pts = 1)
+      : st(st), pts(pts), on(Prof::enabled()) {
+    if (on) { t_s = std::chrono::steady_clock::now(); }
+  }
+  ~ProfTimer() {
+    if (on) {
+      Prof::add(st, std::chrono::duration<double>(
+          std::chrono::steady_clock::now() - t_s).count(), pts);
+    }
+  }
+  ProfTimer(const ProfTimer&) = delete;
+  ProfTimer& operator=(const ProfTimer&) = delete;
+};
+
+}  // namespace iss_sgp4_json
+
+#endif
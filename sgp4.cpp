@@ -1,9 +1,10 @@
 #include "sgp4.hpp"
 
+#include "prof.hpp"
+
 namespace iss_sgp4_json {
 
 // 定数
-static constexpr double kE9          = 1.0e9;
 static constexpr char   kWgs72Old[]  = "wgs72old";
 static constexpr char   kWgs72[]     = "wgs72";
 static constexpr char   kWgs84[]     = "wgs84";
@@ -30,18 +31,39 @@ static constexpr double kPi2         = kPi * 2.0;            // 円周率 * 2
 static constexpr double kMinD        = 1440.0;               // Minutes per day
 static constexpr double kXpdotp      = kMinD / (2.0 * kPi);  // 229.1831180523293
 static constexpr double kDeg2Rad     = kPi / 180.0;          // 0.0174532925199433
+static constexpr unsigned int kSatMax = 256;                 // 初期化済み衛星情報の保持上限
+static constexpr unsigned int kDsCkpt = 10;                  // 共鳴項の積分のチェックポイントの間隔(ステップ)
+
+// 重力モデル毎の定数（コンパイル時定数; get_gravconst と同じ値）
+template <Grav> struct GravConst;
+template <> struct GravConst<Grav::kWgs72Old> {
+  static constexpr double r     = kWgs72OldR;
+  static constexpr double xke   = kWgs72OldXke;
+  static constexpr double j2    = kWgs72OldJ2;
+  static constexpr double j3oj2 = kWgs72OldJ3 / kWgs72OldJ2;
+};
+template <> struct GravConst<Grav::kWgs72> {
+  static constexpr double r     = kWgs72R;
+  static constexpr double xke   = 60.0 / sqrt(r * r * r / kWgs72Mu);
+  static constexpr double j2    = kWgs72J2;
+  static constexpr double j3oj2 = kWgs72J3 / kWgs72J2;
+};
+template <> struct GravConst<Grav::kWgs84> {
+  static constexpr double r     = kWgs84R;
+  static constexpr double xke   = 60.0 / sqrt(r * r * r / kWgs84Mu);
+  static constexpr double j2    = kWgs84J2;
+  static constexpr double j3oj2 = kWgs84J3 / kWgs84J2;
+};
 
 /*
  * @brief      コンストラクタ
  *
- * @param[in]  UT1 (timespec)
- * @param[in]  TLE (vector<string>)
  * @param[in]  測地系 (string; optional)
  */
-Sgp4::Sgp4(struct timespec ut1, std::vector<std::string> tle, std::string wgs) {
-  this->ut1 = ut1;
-  this->tle = tle;
-  cst = get_gravconst(wgs);
+Sgp4::Sgp4(std::string wgs) {
+  cst  = get_gravconst(wgs);
+  grav = wgs == kWgs72Old ? Grav::kWgs72Old
+       : wgs == kWgs72    ? Grav::kWgs72 : Grav::kWgs84;
 }
 
 /*
@@ -52,10 +74,12 @@ Sgp4::Sgp4(struct timespec ut1, std::vector<std::string> tle, std::string wgs) {
  *            this version follows the methodology from the aiaa paper (2006) 
  *            describing the history and development of the code.
  *
- * @param   <none>
- * @return  衛星情報 (Satellite)
+ * @param[in]  TLE (vector<string>)
+ * @param[in]  AFSPC モード (bool; optional)
+ * @return     衛星情報 (Satellite)
  */
-Satellite Sgp4::twoline2rv(bool afspc_mode) {
+Satellite Sgp4::twoline2rv(
+    const std::vector<std::string>& tle, bool afspc_mode) {
   int          nexp;
   int          ibexp;
   unsigned int two_digit_year;
@@ -64,6 +88,8 @@ Satellite Sgp4::twoline2rv(bool afspc_mode) {
   Satellite    sat;
 
   try {
+    ProfTimer pt(Stage::kInit);
+
     sat.opsmode = 'i';
     if (afspc_mode) { sat.opsmode = 'a'; }
 
@@ -129,31 +155,81 @@ Satellite Sgp4::twoline2rv(bool afspc_mode) {
   return sat;
 }  // twoline2rv
 
+/*
+ * @brief      初期化済み衛星情報の取得
+ *             * 同じ TLE に対しては twoline2rv（sgp4init）を再実行せず、
+ *               初期化済みの衛星情報を返す
+ *             * 保持件数が上限に達したら、最も長く取得されていないもの1件
+ *               だけを破棄する
+ *             * 返した参照は、その後に別の TLE が kSatMax - 1 種類取得される
+ *               まで有効（直前に返した参照が次の呼び出しで無効になることは
+ *               ない; 要素はノードで保持されるため再ハッシュでも移動しない）
+ *
+ * @param[in]  TLE (vector<string>)
+ * @return     衛星情報 (Satellite&)
+ */
+Satellite& Sgp4::get_sat(const std::vector<std::string>& tle) {
+  std::string key;
+  std::unordered_map<std::string, SatCache>::iterator it;
+  std::unordered_map<std::string, SatCache>::iterator it_o;  // 破棄するもの
+
+  try {
+    key = tle[0] + tle[1];
+    it  = sats.find(key);
+    if (it == sats.end()) {
+      if (sats.size() >= kSatMax) {
+        it_o = sats.begin();
+        for (it = sats.begin(); it != sats.end(); ++it) {
+          if (it->second.used < it_o->second.used) { it_o = it; }
+        }
+        sats.erase(it_o);
+      }
+      it = sats.emplace(key, SatCache{twoline2rv(tle), 0}).first;
+    }
+    it->second.used = ++n_get;
+  } catch (...) {
+    throw;
+  }
+
+  return it->second.sat;
+}
+
+/*
+ * @brief       元期から指定経過時間(分)の位置・速度の取得
+ *
+ * @param[ref]  sat (Satellite)
+ * @param[in]   元期からの経過時間(分) (double)
+ * @return      位置・速度 (PvTeme)
+ */
+PvTeme Sgp4::propagate(Satellite& sat, double tsince) {
+  PvTeme teme = {{0.0, 0.0, 0.0}, {0.0, 0.0, 0.0}};
+
+  try {
+    teme = sgp4(tsince, sat);
+  } catch (...) {
+    throw;
+  }
+
+  return teme;
+}
+
 /*
  * @brief       指定 UT1 の ISS 位置・速度の取得
  *              * Return a position and velocity vector for a given date and 
  *                time.
  *
  * @param[ref]  sat (Satellite)
+ * @param[in]   UT1 (timespec)
  * @return      位置・速度 (PvTeme)
  */
-PvTeme Sgp4::propagate(Satellite& sat) {
-  std::string ut1_str;
-  DateTime    dt;
-  double      j;
-  double      m;
-  PvTeme      teme = {{0.0, 0.0, 0.0}, {0.0, 0.0, 0.0}};
+PvTeme Sgp4::propagate(Satellite& sat, struct timespec ut1) {
+  JulianDay jd;
+  double    m;
+  PvTeme    teme = {{0.0, 0.0, 0.0}, {0.0, 0.0, 0.0}};
 
   try {
-    ut1_str = gen_time_str(ut1);
-    dt.year   = stoi(ut1_str.substr( 0, 4));
-    dt.month  = stoi(ut1_str.substr( 5, 2));
-    dt.day    = stoi(ut1_str.substr( 8, 2));
-    dt.hour   = stoi(ut1_str.substr(11, 2));
-    dt.minute = stoi(ut1_str.substr(14, 2));
-    dt.second = stod(ut1_str.substr(17, 2)) + ut1.tv_nsec / kE9;
-    j = jday(dt);
-    m = (j - sat.jdsatepoch) * kMinD;
+    jd = ts2jd(ut1);
+    m  = ((jd.jd - sat.jdsatepoch) + jd.fr) * kMinD;
     teme = sgp4(m, sat);
   } catch (...) {
     throw;
@@ -162,15 +238,60 @@ PvTeme Sgp4::propagate(Satellite& sat) {
   return teme;
 }
 
+/*
+ * @brief       元期から指定経過時間(分)の位置・速度の取得(特殊化版)
+ *              * 重力モデル・伝播方法で特殊化した sgp4() で計算する
+ *                (結果は propagate と同じ; 処理速度の比較用)
+ *
+ * @param[ref]  sat (Satellite)
+ * @param[in]   元期からの経過時間(分) (double)
+ * @return      位置・速度 (PvTeme)
+ */
+PvTeme Sgp4::propagate_spec(Satellite& sat, double tsince) {
+  PvTeme teme = {{0.0, 0.0, 0.0}, {0.0, 0.0, 0.0}};
+
+  try {
+    teme = (this->*dispatch(sat))(tsince, sat);
+  } catch (...) {
+    throw;
+  }
+
+  return teme;
+}
+
 /********************************************
  **** 以下、 private function/procedures ****
  ********************************************/
 
+/*
+ * @brief      特殊化した sgp4() の選択
+ *             * 重力モデル・method・isimp から選ぶ
+ *
+ * @param[in]  sat (Satellite)
+ * @return     特殊化した sgp4() (Sgp4Fn)
+ */
+Sgp4Fn Sgp4::dispatch(const Satellite& sat) {
+  static constexpr Sgp4Fn kFns[3][3] = {
+    {&Sgp4::sgp4_s<Grav::kWgs72Old, Sgp4Mode::kNear>,
+     &Sgp4::sgp4_s<Grav::kWgs72Old, Sgp4Mode::kNearSimp>,
+     &Sgp4::sgp4_s<Grav::kWgs72Old, Sgp4Mode::kDeep>},
+    {&Sgp4::sgp4_s<Grav::kWgs72, Sgp4Mode::kNear>,
+     &Sgp4::sgp4_s<Grav::kWgs72, Sgp4Mode::kNearSimp>,
+     &Sgp4::sgp4_s<Grav::kWgs72, Sgp4Mode::kDeep>},
+    {&Sgp4::sgp4_s<Grav::kWgs84, Sgp4Mode::kNear>,
+     &Sgp4::sgp4_s<Grav::kWgs84, Sgp4Mode::kNearSimp>,
+     &Sgp4::sgp4_s<Grav::kWgs84, Sgp4Mode::kDeep>}
+  };
+
+  return kFns[static_cast<int>(grav)]
+             [sat.method == 'd' ? 2 : sat.isimp == 1 ? 1 : 0];
+}
+
 /*
  * @brief      定数取得
  *
  * @param[in]  測地系 ("wgs72old"|"wgs72"|"wgs84") (string)
- *             (default: "wgs84")
+ *             (default: "wgs84"; それ以外も "wgs84" とする)
  * @return     定数セット (Const)
  */
 Const Sgp4::get_gravconst(std::string wgs) {
@@ -191,7 +312,7 @@ Const Sgp4::get_gravconst(std::string wgs) {
       cst.j2  = kWgs72J2;
       cst.j3  = kWgs72J3;
       cst.j4  = kWgs72J4;
-    } else if (wgs == kWgs84) {
+    } else {
       cst.r   = kWgs84R;
       cst.mu  = kWgs84Mu;
       cst.xke = 60.0 / sqrt(cst.r * cst.r * cst.r / cst.mu);
@@ -426,6 +547,7 @@ void Sgp4::sgp4init(Satellite& sat) {
       if (kPi2 / sat.no >= 225.0) {
         sat.method = 'd';
         sat.isimp  = 1;
+        sat.ds.alloc();
         tc         =  0.0;
         inclm      = sat.inclo;
 
@@ -663,11 +785,11 @@ void Sgp4::dscom(
     rtemsq = sqrt(betasq);
 
     // ---- initialize lunar solar terms ----
-    sat.peo   = 0.0;
-    sat.pinco = 0.0;
-    sat.plo   = 0.0;
-    sat.pgho  = 0.0;
-    sat.pho   = 0.0;
+    sat.ds->peo   = 0.0;
+    sat.ds->pinco = 0.0;
+    sat.ds->plo   = 0.0;
+    sat.ds->pgho  = 0.0;
+    sat.ds->pho   = 0.0;
     day    = epoch + 18261.5 + tc / 1440.0;
     xnodce = fmod(4.5236020 - 9.2422029e-4 * day, kPi2);
     stem   = sin(xnodce);
@@ -775,36 +897,36 @@ void Sgp4::dscom(
       }
     }
 
-    sat.zmol = fmod(4.7199672 + 0.22997150  * day - gam, kPi2);
-    sat.zmos = fmod(6.2565837 + 0.017201977 * day, kPi2);
+    sat.ds->zmol = fmod(4.7199672 + 0.22997150  * day - gam, kPi2);
+    sat.ds->zmos = fmod(6.2565837 + 0.017201977 * day, kPi2);
 
     // ---- do solar terms ----
-    sat.se2  =   2.0 * ss1 * ss6;
-    sat.se3  =   2.0 * ss1 * ss7;
-    sat.si2  =   2.0 * ss2 * sz12;
-    sat.si3  =   2.0 * ss2 * (sz13 - sz11);
-    sat.sl2  =  -2.0 * ss3 * sz2;
-    sat.sl3  =  -2.0 * ss3 * (sz3 - sz1);
-    sat.sl4  =  -2.0 * ss3 * (-21.0 - 9.0 * emsq) * kZes;
-    sat.sgh2 =   2.0 * ss4 * sz32;
-    sat.sgh3 =   2.0 * ss4 * (sz33 - sz31);
-    sat.sgh4 = -18.0 * ss4 * kZes;
-    sat.sh2  =  -2.0 * ss2 * sz22;
-    sat.sh3  =  -2.0 * ss2 * (sz23 - sz21);
+    sat.ds->se2  =   2.0 * ss1 * ss6;
+    sat.ds->se3  =   2.0 * ss1 * ss7;
+    sat.ds->si2  =   2.0 * ss2 * sz12;
+    sat.ds->si3  =   2.0 * ss2 * (sz13 - sz11);
+    sat.ds->sl2  =  -2.0 * ss3 * sz2;
+    sat.ds->sl3  =  -2.0 * ss3 * (sz3 - sz1);
+    sat.ds->sl4  =  -2.0 * ss3 * (-21.0 - 9.0 * emsq) * kZes;
+    sat.ds->sgh2 =   2.0 * ss4 * sz32;
+    sat.ds->sgh3 =   2.0 * ss4 * (sz33 - sz31);
+    sat.ds->sgh4 = -18.0 * ss4 * kZes;
+    sat.ds->sh2  =  -2.0 * ss2 * sz22;
+    sat.ds->sh3  =  -2.0 * ss2 * (sz23 - sz21);
 
     // ---- do lunar terms ----
-    sat.ee2  =   2.0 * s1 * s6;
-    sat.e3   =   2.0 * s1 * s7;
-    sat.xi2  =   2.0 * s2 * z12;
-    sat.xi3  =   2.0 * s2 * (z13 - z11);
-    sat.xl2  =  -2.0 * s3 * z2;
-    sat.xl3  =  -2.0 * s3 * (z3 - z1);
-    sat.xl4  =  -2.0 * s3 * (-21.0 - 9.0 * emsq) * kZel;
-    sat.xgh2 =   2.0 * s4 * z32;
-    sat.xgh3 =   2.0 * s4 * (z33 - z31);
-    sat.xgh4 = -18.0 * s4 * kZel;
-    sat.xh2  =  -2.0 * s2 * z22;
-    sat.xh3  =  -2.0 * s2 * (z23 - z21);
+    sat.ds->ee2  =   2.0 * s1 * s6;
+    sat.ds->e3   =   2.0 * s1 * s7;
+    sat.ds->xi2  =   2.0 * s2 * z12;
+    sat.ds->xi3  =   2.0 * s2 * (z13 - z11);
+    sat.ds->xl2  =  -2.0 * s3 * z2;
+    sat.ds->xl3  =  -2.0 * s3 * (z3 - z1);
+    sat.ds->xl4  =  -2.0 * s3 * (-21.0 - 9.0 * emsq) * kZel;
+    sat.ds->xgh2 =   2.0 * s4 * z32;
+    sat.ds->xgh3 =   2.0 * s4 * (z33 - z31);
+    sat.ds->xgh4 = -18.0 * s4 * kZel;
+    sat.ds->xh2  =  -2.0 * s2 * z22;
+    sat.ds->xh3  =  -2.0 * s2 * (z23 - z21);
   } catch (...) {
     throw;
   }
@@ -908,11 +1030,11 @@ void Sgp4::dsinit(
     zns    = 1.19459e-5;
 
     // ---- deep space initialization ----
-    sat.irez = 0;
+    sat.ds->irez = 0;
     if (0.0034906585 < nm && nm < 0.0052359877) {
-      sat.irez = 1;
+      sat.ds->irez = 1;
     } else if (8.26e-3 <= nm && nm <= 9.24e-3 && em >= 0.5) {
-      sat.irez = 2;
+      sat.ds->irez = 2;
     }
 
     // ---- do solar terms ----
@@ -930,36 +1052,36 @@ void Sgp4::dsinit(
     sgs  = sghs - cosim * shs;
 
     // ---- do lunar terms ----
-    sat.dedt = ses + s1 * znl * s5;
-    sat.didt = sis + s2 * znl * (z11 + z13);
-    sat.dmdt = sls - znl * s3 * (z1 + z3 - 14.0 - 6.0 * emsq);
+    sat.ds->dedt = ses + s1 * znl * s5;
+    sat.ds->didt = sis + s2 * znl * (z11 + z13);
+    sat.ds->dmdt = sls - znl * s3 * (z1 + z3 - 14.0 - 6.0 * emsq);
     sghl     = s4 * znl * (z31 + z33 - 6.0);
     shll     = -znl * s2 * (z21 + z23);
     // sgp4fix for 180 deg incl
     if (inclm < 5.2359877e-2 || inclm > kPi - 5.2359877e-2) {
       shll = 0.0;
     }
-    sat.domdt = sgs + sghl;
-    sat.dnodt = shs;
+    sat.ds->domdt = sgs + sghl;
+    sat.ds->dnodt = shs;
     if (sinim != 0.0) {
-      sat.domdt -= cosim / sinim * shll;
-      sat.dnodt += shll  / sinim;
+      sat.ds->domdt -= cosim / sinim * shll;
+      sat.ds->dnodt += shll  / sinim;
     }
 
     // ---- calculate deep space resonance effects ----
     dndt   = 0.0;
     theta  = fmod(sat.gsto + tc * rptim, kPi2);
-    em    += sat.dedt  * sat.t;
-    inclm += sat.didt  * sat.t;
-    argpm += sat.domdt * sat.t;
-    nodem += sat.dnodt * sat.t;
-    mm    += sat.dmdt  * sat.t;
+    em    += sat.ds->dedt  * sat.t;
+    inclm += sat.ds->didt  * sat.t;
+    argpm += sat.ds->domdt * sat.t;
+    nodem += sat.ds->dnodt * sat.t;
+    mm    += sat.ds->dmdt  * sat.t;
 
     // ---- initialize the resonance terms ----
-    if (sat.irez != 0) { aonv = pow((nm / cst.xke), x2o3); }
+    if (sat.ds->irez != 0) { aonv = pow((nm / cst.xke), x2o3); }
 
     // ---- geopotential resonance for 12 hour orbits ----
-    if (sat.irez == 2) {
+    if (sat.ds->irez == 2) {
       cosisq = cosim * cosim;
       emo    = em;
       em     = sat.ecco;
@@ -1018,31 +1140,31 @@ void Sgp4::dsinit(
       ainv2     = aonv * aonv;
       temp1     = 3.0 * xno2 * ainv2;
       temp      = temp1 * root22;
-      sat.d2201 = temp * f220 * g201;
-      sat.d2211 = temp * f221 * g211;
+      sat.ds->d2201 = temp * f220 * g201;
+      sat.ds->d2211 = temp * f221 * g211;
       temp1     = temp1 * aonv;
       temp      = temp1 * root32;
-      sat.d3210 = temp * f321 * g310;
-      sat.d3222 = temp * f322 * g322;
+      sat.ds->d3210 = temp * f321 * g310;
+      sat.ds->d3222 = temp * f322 * g322;
       temp1     = temp1 * aonv;
       temp      = 2.0 * temp1 * root44;
-      sat.d4410 = temp * f441 * g410;
-      sat.d4422 = temp * f442 * g422;
+      sat.ds->d4410 = temp * f441 * g410;
+      sat.ds->d4422 = temp * f442 * g422;
       temp1     = temp1 * aonv;
       temp      = temp1 * root52;
-      sat.d5220 = temp * f522 * g520;
-      sat.d5232 = temp * f523 * g532;
+      sat.ds->d5220 = temp * f522 * g520;
+      sat.ds->d5232 = temp * f523 * g532;
       temp      = 2.0 * temp1 * root54;
-      sat.d5421 = temp * f542 * g521;
-      sat.d5433 = temp * f543 * g533;
-      sat.xlamo = fmod(sat.mo + sat.nodeo + sat.nodeo - theta - theta, kPi2);
-      sat.xfact = sat.mdot + sat.dmdt + 2.0 * (sat.nodedot + sat.dnodt - rptim)
+      sat.ds->d5421 = temp * f542 * g521;
+      sat.ds->d5433 = temp * f543 * g533;
+      sat.ds->xlamo = fmod(sat.mo + sat.nodeo + sat.nodeo - theta - theta, kPi2);
+      sat.ds->xfact = sat.mdot + sat.ds->dmdt + 2.0 * (sat.nodedot + sat.ds->dnodt - rptim)
                 - sat.no;
       em        = emo;
       emsq      = emsqo;
 
     // ---- synchronous resonance terms ----
-    } else if (sat.irez == 1) {
+    } else if (sat.ds->irez == 1) {
       g200      = 1.0 + emsq * (-2.5 + 0.8125 * emsq);
       g310      = 1.0 + 2.0 * emsq;
       g300      = 1.0 + emsq * (-6.0 + 6.60937 * emsq);
@@ -1051,19 +1173,19 @@ void Sgp4::dsinit(
                 - 0.75 * (1.0 + cosim);
       f330      = 1.0 + cosim;
       f330      = 1.875 * f330 * f330 * f330;
-      sat.del1  = 3.0 * nm * nm * aonv * aonv;
-      sat.del2  = 2.0 * sat.del1 * f220 * g200 * q22;
-      sat.del3  = 3.0 * sat.del1 * f330 * g300 * q33 * aonv;
-      sat.del1 *= f311 * g310 * q31 * aonv;
-      sat.xlamo = fmod(sat.mo + sat.nodeo + sat.argpo - theta, kPi2);
-      sat.xfact = sat.mdot + xpidot - rptim + sat.dmdt + sat.domdt + sat.dnodt
+      sat.ds->del1  = 3.0 * nm * nm * aonv * aonv;
+      sat.ds->del2  = 2.0 * sat.ds->del1 * f220 * g200 * q22;
+      sat.ds->del3  = 3.0 * sat.ds->del1 * f330 * g300 * q33 * aonv;
+      sat.ds->del1 *= f311 * g310 * q31 * aonv;
+      sat.ds->xlamo = fmod(sat.mo + sat.nodeo + sat.argpo - theta, kPi2);
+      sat.ds->xfact = sat.mdot + xpidot - rptim + sat.ds->dmdt + sat.ds->domdt + sat.ds->dnodt
                 - sat.no;
     }
 
     // ---- for sgp4, initialize the integrator ----
-    sat.xli   = sat.xlamo;
-    sat.xni   = sat.no;
-    sat.atime = 0.0;
+    sat.ds->xli   = sat.ds->xlamo;
+    sat.ds->xni   = sat.no;
+    sat.ds->atime = 0.0;
     nm        = sat.no + dndt;
   } catch (...) {
     throw;
@@ -1077,12 +1199,23 @@ void Sgp4::dsinit(
  *                which were originally published separately in spacetrack 
  *                report #3. this version follows the methodology from the aiaa 
  *                paper (2006) describing the history and development of the code.
+ *              * 定数の型(C: Const か GravConst<G>)・伝播方法(M)で特殊化する
+ *                (sgp4() は Const・kGeneric、sgp4_s() は GravConst・伝播方法毎)
+ *              * sat.kep_seq なら Kepler 方程式の初期値に前回の解を使う
+ *                (解いた回数・反復回数は sat.kep_n, sat.kep_itr に加算)
  *
  * @param[in]   tsince (double)
  * @param[ref]  sat (Satellite )
+ * @param[in]   定数 (C)
  * @return      位置・速度 (PvTeme)
  */
-PvTeme Sgp4::sgp4(double tsince, Satellite& sat) {
+template <class C, Sgp4Mode M>
+PvTeme Sgp4::sgp4_k(double tsince, Satellite& sat, const C& c) {
+  // 伝播方法（特殊化した場合はコンパイル時に決まり、分岐は除かれる）
+  const bool deep = M == Sgp4Mode::kGeneric ? sat.method == 'd'
+                  : M == Sgp4Mode::kDeep;
+  const bool drag = M == Sgp4Mode::kGeneric ? sat.isimp != 1
+                  : M == Sgp4Mode::kNear;
   int    ktr;
   double mrt;
   double temp;
@@ -1177,7 +1310,7 @@ PvTeme Sgp4::sgp4(double tsince, Satellite& sat) {
     temp4 = 1.5e-12;
     x2o3  = 2.0 / 3.0;
     // sgp4fix identify constants and allow alternate values
-    vkmpersec = cst.r * cst.xke / 60.0;
+    vkmpersec = c.r * c.xke / 60.0;
 
     // ---- clear sgp4 error flag ----
     sat.t = tsince;
@@ -1194,7 +1327,7 @@ PvTeme Sgp4::sgp4(double tsince, Satellite& sat) {
     tempe  = sat.bstar * sat.cc4 * sat.t;
     templ  = sat.t2cof * t2;
 
-    if (sat.isimp != 1) {
+    if (drag) {
       delomg = sat.omgcof * sat.t;
       // sgp4fix use mutliply for speed instead of pow
       delmtemp = 1.0 + sat.eta * cos(xmdf);
@@ -1212,7 +1345,7 @@ PvTeme Sgp4::sgp4(double tsince, Satellite& sat) {
     nm    = sat.no;
     em    = sat.ecco;
     inclm = sat.inclo;
-    if (sat.method == 'd') {
+    if (deep) {
       tc = sat.t;
       dspace(tc, em, argpm, inclm, mm, nodem, nm, dndt, sat);
     }
@@ -1223,8 +1356,8 @@ PvTeme Sgp4::sgp4(double tsince, Satellite& sat) {
     }
 
     // mean motion less than 0.0
-    am  = pow(cst.xke / nm, x2o3) * tempa * tempa;
-    nm  = cst.xke / pow(am, 1.5);
+    am  = pow(c.xke / nm, x2o3) * tempa * tempa;
+    nm  = c.xke / pow(am, 1.5);
     em -= tempe;
 
     // fix tolerance for error recognition
@@ -1258,7 +1391,7 @@ PvTeme Sgp4::sgp4(double tsince, Satellite& sat) {
     mp    = mm;
     sinip = sinim;
     cosip = cosim;
-    if (sat.method == 'd') {
+    if (deep) {
       dpper('n', ep, xincp, nodep, argpp, mp, sat);
 
       if (xincp < 0.0) {
@@ -1274,16 +1407,16 @@ PvTeme Sgp4::sgp4(double tsince, Satellite& sat) {
     }
 
     // ---- long period periodics ----
-    if (sat.method == 'd') {
+    if (deep) {
       sinip = sin(xincp);
       cosip = cos(xincp);
-      sat.aycof = -0.5 * cst.j3oj2 * sinip;
+      sat.aycof = -0.5 * c.j3oj2 * sinip;
       // sgp4fix for divide by zero for xincp = 180 deg
       if (fabs(cosip + 1.0) > 1.5e-12) {
-        sat.xlcof = -0.25 * cst.j3oj2 * sinip * (3.0 + 5.0 * cosip)
+        sat.xlcof = -0.25 * c.j3oj2 * sinip * (3.0 + 5.0 * cosip)
                   / (1.0 + cosip);
       } else {
-        sat.xlcof = -0.25 * cst.j3oj2 * sinip * (3.0 + 5.0 * cosip)
+        sat.xlcof = -0.25 * c.j3oj2 * sinip * (3.0 + 5.0 * cosip)
                   / temp4;
       }
     }
@@ -1294,8 +1427,10 @@ PvTeme Sgp4::sgp4(double tsince, Satellite& sat) {
     xl   = mp + argpp + nodep + temp * sat.xlcof * axnl;
 
     // ---- solve kepler's equation ----
+    // * 逐次解法では前回の解と平均経度の差(e sin E 相当; 計算時刻が近ければ
+    //   ほぼ同じ)を初期値に加える
     u    = fmod(xl - nodep, kPi2);
-    eo1  = u;
+    eo1  = sat.kep_seq ? u + sat.kep_off : u;
     tem5 = 9999.9;
     ktr  = 1;
     // sgp4fix for kepler iteration
@@ -1315,6 +1450,9 @@ PvTeme Sgp4::sgp4(double tsince, Satellite& sat) {
       eo1 += tem5;
       ++ktr;
     }
+    sat.kep_off  = eo1 - u;
+    sat.kep_n   += 1;
+    sat.kep_itr += ktr - 1;
 
     // ---- short period preliminary quantities ----
     ecose = axnl * coseo1 + aynl * sineo1;
@@ -1336,11 +1474,11 @@ PvTeme Sgp4::sgp4(double tsince, Satellite& sat) {
       sin2u  = (cosu + cosu) * sinu;
       cos2u  = 1.0 - 2.0 * sinu * sinu;
       temp   = 1.0 / pl;
-      temp1  = 0.5 * cst.j2 * temp;
+      temp1  = 0.5 * c.j2 * temp;
       temp2  = temp1 * temp;
 
       // ---- update for short period periodics ----
-      if (sat.method == 'd') {
+      if (deep) {
         cosisq = cosip * cosip;
         sat.con41  = 3.0 * cosisq - 1.0;
         sat.x1mth2 = 1.0 - cosisq;
@@ -1352,9 +1490,9 @@ PvTeme Sgp4::sgp4(double tsince, Satellite& sat) {
       su   -= 0.25 * temp2 * sat.x7thm1 * sin2u;
       xnode = nodep + 1.5 * temp2 * cosip * sin2u;
       xinc  = xincp + 1.5 * temp2 * cosip * sinip * cos2u;
-      mvt   = rdotl - nm * temp1 * sat.x1mth2 * sin2u / cst.xke;
+      mvt   = rdotl - nm * temp1 * sat.x1mth2 * sin2u / c.xke;
       rvdot = rvdotl + nm * temp1 * (sat.x1mth2 * cos2u
-            + 1.5 * sat.con41) / cst.xke;
+            + 1.5 * sat.con41) / c.xke;
 
       // ---- orientation vectors ----
       sinsu =  sin(su);
@@ -1373,7 +1511,7 @@ PvTeme Sgp4::sgp4(double tsince, Satellite& sat) {
       vz    =  sini * cossu;
 
       // ---- position and velocity (in km and km/sec) ----
-      mr = mrt * cst.r;
+      mr = mrt * c.r;
       teme.r.x = mr * ux;
       teme.r.y = mr * uy;
       teme.r.z = mr * uz;
@@ -1389,7 +1527,33 @@ PvTeme Sgp4::sgp4(double tsince, Satellite& sat) {
   }
 
   return teme;
-}  // sgp4
+}  // sgp4_k
+
+/*
+ * @brief       SGP4 prediction model
+ *              * 定数(cst)・method・isimp を実行時に参照する
+ *
+ * @param[in]   tsince (double)
+ * @param[ref]  sat (Satellite )
+ * @return      位置・速度 (PvTeme)
+ */
+PvTeme Sgp4::sgp4(double tsince, Satellite& sat) {
+  return sgp4_k<Const, Sgp4Mode::kGeneric>(tsince, sat, cst);
+}
+
+/*
+ * @brief       SGP4 prediction model(重力モデル・伝播方法で特殊化)
+ *              * 定数はコンパイル時定数(GravConst)、method・isimp の分岐は
+ *                コンパイル時に除く
+ *
+ * @param[in]   tsince (double)
+ * @param[ref]  sat (Satellite )
+ * @return      位置・速度 (PvTeme)
+ */
+template <Grav G, Sgp4Mode M>
+PvTeme Sgp4::sgp4_s(double tsince, Satellite& sat) {
+  return sgp4_k<GravConst<G>, M>(tsince, sat, GravConst<G>{});
+}
 
 /*
  * @brief       Deep space contributions
@@ -1398,6 +1562,11 @@ PvTeme Sgp4::sgp4(double tsince, Satellite& sat) {
  *                averaged over one revolution of the sun and moon.  for earth 
  *                resonance effects, the effects have been averaged over no 
  *                revolutions of the satellite.  (mean motion)
+ *              * 共鳴項の積分は kDsCkpt ステップ毎の状態をチェックポイントとして
+ *                保持し、前回の状態から進められない（逆向き・元期の反対側）
+ *                場合も、計算時刻を越えない最も遠いチェックポイントから積分
+ *                し直す（元期から積分した場合と同じ値; 1回あたりの積分は
+ *                kDsCkpt ステップ程度で済む）
  *
  * @param[in]   tc (double)
  * @param[ref]  em, argpm, inclm, mm, nodem, nm, dndt (double)
@@ -1432,6 +1601,10 @@ void Sgp4::dspace(
   double xldot;
   double xnddt;
   double xndt;
+  double span;               // チェックポイントの間隔(分)
+  unsigned long j;           // 積分を始めるチェックポイント(0: 元期)
+  unsigned long n_st;        // 元期からのステップ数
+  std::vector<DsCkpt>* ck;   // チェックポイント一覧(計算時刻と同じ向き)
 
   try {
     fasx2 = 0.13130908;
@@ -1450,11 +1623,11 @@ void Sgp4::dspace(
     // ---- calculate deep space resonance effects ----
     dndt   = 0.0;
     theta  = fmod(sat.gsto + tc * rptim, kPi2);
-    em    += sat.dedt * sat.t;
-    inclm += sat.didt * sat.t;
-    argpm += sat.domdt * sat.t;
-    nodem += sat.dnodt * sat.t;
-    mm    += sat.dmdt * sat.t;
+    em    += sat.ds->dedt * sat.t;
+    inclm += sat.ds->didt * sat.t;
+    argpm += sat.ds->domdt * sat.t;
+    nodem += sat.ds->dnodt * sat.t;
+    mm    += sat.ds->dmdt * sat.t;
 
     // ---- epoch restart ----
     // sgp4fix for propagator problems
@@ -1463,13 +1636,25 @@ void Sgp4::dspace(
     //
     // sgp4fix take out atime = 0.0 and fix for faster operation
     ft = 0.0;
-    if (sat.irez != 0) {
+    if (sat.ds->irez != 0) {
+      // 計算時刻を越えない最も遠いチェックポイント
+      ck   = (sat.t > 0.0) ? &sat.ds->ck_p : &sat.ds->ck_n;
+      span = stepp * kDsCkpt;
+      j    = std::min(static_cast<unsigned long>(fabs(sat.t) / span),
+                      static_cast<unsigned long>(ck->size()));
       // sgp4fix streamline check
-      if (sat.atime == 0.0 || sat.t * sat.atime <= 0.0 ||
-          abs(sat.t) < abs(sat.atime)) {
-        sat.atime = 0.0;
-        sat.xni   = sat.no;
-        sat.xli   = sat.xlamo;
+      // (チェックポイントの方が前回の状態より近い場合も積分し直す)
+      if (sat.ds->atime == 0.0 || sat.t * sat.ds->atime <= 0.0 ||
+          abs(sat.t) < abs(sat.ds->atime) || j * span > fabs(sat.ds->atime)) {
+        if (j == 0) {
+          sat.ds->atime = 0.0;
+          sat.ds->xni   = sat.no;
+          sat.ds->xli   = sat.ds->xlamo;
+        } else {
+          sat.ds->atime = (sat.t > 0.0) ? j * span : -(j * span);
+          sat.ds->xni   = (*ck)[j - 1].xni;
+          sat.ds->xli   = (*ck)[j - 1].xli;
+        }
       }
 
       // sgp4fix move check outside loop
@@ -1480,63 +1665,68 @@ void Sgp4::dspace(
       while (iretn == 381) {
         // ---- dot terms calculated ------------------
         // ---- near - synchronous resonance terms ----
-        if (sat.irez != 2) {
-          xndt  = sat.del1 * sin(sat.xli - fasx2)
-                + sat.del2 * sin(2.0 * (sat.xli - fasx4))
-                + sat.del3 * sin(3.0 * (sat.xli - fasx6));
-          xldot = sat.xni + sat.xfact;
-          xnddt = sat.del1 * cos(sat.xli - fasx2)
-                + 2.0 * sat.del2 * cos(2.0 * (sat.xli - fasx4))
-                + 3.0 * sat.del3 * cos(3.0 * (sat.xli - fasx6));
+        if (sat.ds->irez != 2) {
+          xndt  = sat.ds->del1 * sin(sat.ds->xli - fasx2)
+                + sat.ds->del2 * sin(2.0 * (sat.ds->xli - fasx4))
+                + sat.ds->del3 * sin(3.0 * (sat.ds->xli - fasx6));
+          xldot = sat.ds->xni + sat.ds->xfact;
+          xnddt = sat.ds->del1 * cos(sat.ds->xli - fasx2)
+                + 2.0 * sat.ds->del2 * cos(2.0 * (sat.ds->xli - fasx4))
+                + 3.0 * sat.ds->del3 * cos(3.0 * (sat.ds->xli - fasx6));
           xnddt *= xldot;
         } else {
           // ---- near - half-day resonance terms ----
-          xomi  = sat.argpo + sat.argpdot * sat.atime;
+          xomi  = sat.argpo + sat.argpdot * sat.ds->atime;
           x2omi = xomi + xomi;
-          x2li  = sat.xli + sat.xli;
-          xndt  = (sat.d2201 * sin(x2omi + sat.xli - g22)
-                +  sat.d2211 * sin(        sat.xli - g22)
-                +  sat.d3210 * sin( xomi + sat.xli - g32)
-                +  sat.d3222 * sin(-xomi + sat.xli - g32)
-                +  sat.d4410 * sin(x2omi + x2li    - g44)
-                +  sat.d4422 * sin(        x2li    - g44)
-                +  sat.d5220 * sin( xomi + sat.xli - g52)
-                +  sat.d5232 * sin(-xomi + sat.xli - g52)
-                +  sat.d5421 * sin( xomi + x2li    - g54)
-                +  sat.d5433 * sin(-xomi + x2li    - g54));
-          xldot = sat.xni + sat.xfact;
-          xnddt = (sat.d2201 * cos(x2omi + sat.xli - g22)
-                +  sat.d2211 * cos(        sat.xli - g22)
-                +  sat.d3210 * cos( xomi + sat.xli - g32)
-                +  sat.d3222 * cos(-xomi + sat.xli - g32)
-                +  sat.d5220 * cos( xomi + sat.xli - g52)
-                +  sat.d5232 * cos(-xomi + sat.xli - g52)
+          x2li  = sat.ds->xli + sat.ds->xli;
+          xndt  = (sat.ds->d2201 * sin(x2omi + sat.ds->xli - g22)
+                +  sat.ds->d2211 * sin(        sat.ds->xli - g22)
+                +  sat.ds->d3210 * sin( xomi + sat.ds->xli - g32)
+                +  sat.ds->d3222 * sin(-xomi + sat.ds->xli - g32)
+                +  sat.ds->d4410 * sin(x2omi + x2li    - g44)
+                +  sat.ds->d4422 * sin(        x2li    - g44)
+                +  sat.ds->d5220 * sin( xomi + sat.ds->xli - g52)
+                +  sat.ds->d5232 * sin(-xomi + sat.ds->xli - g52)
+                +  sat.ds->d5421 * sin( xomi + x2li    - g54)
+                +  sat.ds->d5433 * sin(-xomi + x2li    - g54));
+          xldot = sat.ds->xni + sat.ds->xfact;
+          xnddt = (sat.ds->d2201 * cos(x2omi + sat.ds->xli - g22)
+                +  sat.ds->d2211 * cos(        sat.ds->xli - g22)
+                +  sat.ds->d3210 * cos( xomi + sat.ds->xli - g32)
+                +  sat.ds->d3222 * cos(-xomi + sat.ds->xli - g32)
+                +  sat.ds->d5220 * cos( xomi + sat.ds->xli - g52)
+                +  sat.ds->d5232 * cos(-xomi + sat.ds->xli - g52)
                 +  2.0
-                * (sat.d4410 * cos(x2omi + x2li - g44)
-                +  sat.d4422 * cos(        x2li - g44)
-                +  sat.d5421 * cos( xomi + x2li - g54)
-                +  sat.d5433 * cos(-xomi + x2li - g54)));
+                * (sat.ds->d4410 * cos(x2omi + x2li - g44)
+                +  sat.ds->d4422 * cos(        x2li - g44)
+                +  sat.ds->d5421 * cos( xomi + x2li - g54)
+                +  sat.ds->d5433 * cos(-xomi + x2li - g54)));
           xnddt *= xldot;
         }
 
         // ---- integrator ----
         // sgp4fix move end checks to end of routine
-        if (fabs(sat.t - sat.atime) >= stepp) {
+        if (fabs(sat.t - sat.ds->atime) >= stepp) {
           iretn = 381;
         } else {
-          ft    = sat.t - sat.atime;
+          ft    = sat.t - sat.ds->atime;
           iretn = 0;
         }
         if (iretn == 381) {
-          sat.xli   += xldot * delt + xndt * step2;
-          sat.xni   += xndt * delt + xnddt * step2;
-          sat.atime += delt;
+          sat.ds->xli   += xldot * delt + xndt * step2;
+          sat.ds->xni   += xndt * delt + xnddt * step2;
+          sat.ds->atime += delt;
+          // チェックポイントの追加（kDsCkpt ステップ毎; 未追加のもののみ）
+          n_st = static_cast<unsigned long>(fabs(sat.ds->atime) / stepp + 0.5);
+          if (n_st % kDsCkpt == 0 && n_st / kDsCkpt == ck->size() + 1) {
+            ck->push_back({sat.ds->xli, sat.ds->xni});
+          }
         }
       }
 
-      nm = sat.xni + xndt  * ft + xnddt * ft * ft * 0.5;
-      xl = sat.xli + xldot * ft + xndt  * ft * ft * 0.5;
-      if (sat.irez != 1) {
+      nm = sat.ds->xni + xndt  * ft + xnddt * ft * ft * 0.5;
+      xl = sat.ds->xli + xldot * ft + xndt  * ft * ft * 0.5;
+      if (sat.ds->irez != 1) {
         mm   = xl - 2.0 * nodem + 2.0 * theta;
         dndt = nm - sat.no;
       } else {
@@ -1637,38 +1827,38 @@ void Sgp4::dpper(
   try {
     // Copy satellite attributes into local variables for convenience
     // and symmetry in writing formulae.
-    e3    = sat.e3;
-    ee2   = sat.ee2;
-    peo   = sat.peo;
-    pgho  = sat.pgho;
-    pho   = sat.pho;
-    pinco = sat.pinco;
-    plo   = sat.plo;
-    se2   = sat.se2;
-    se3   = sat.se3;
-    sgh2  = sat.sgh2;
-    sgh3  = sat.sgh3;
-    sgh4  = sat.sgh4;
-    sh2   = sat.sh2;
-    sh3   = sat.sh3;
-    si2   = sat.si2;
-    si3   = sat.si3;
-    sl2   = sat.sl2;
-    sl3   = sat.sl3;
-    sl4   = sat.sl4;
+    e3    = sat.ds->e3;
+    ee2   = sat.ds->ee2;
+    peo   = sat.ds->peo;
+    pgho  = sat.ds->pgho;
+    pho   = sat.ds->pho;
+    pinco = sat.ds->pinco;
+    plo   = sat.ds->plo;
+    se2   = sat.ds->se2;
+    se3   = sat.ds->se3;
+    sgh2  = sat.ds->sgh2;
+    sgh3  = sat.ds->sgh3;
+    sgh4  = sat.ds->sgh4;
+    sh2   = sat.ds->sh2;
+    sh3   = sat.ds->sh3;
+    si2   = sat.ds->si2;
+    si3   = sat.ds->si3;
+    sl2   = sat.ds->sl2;
+    sl3   = sat.ds->sl3;
+    sl4   = sat.ds->sl4;
     t     = sat.t;
-    xgh2  = sat.xgh2;
-    xgh3  = sat.xgh3;
-    xgh4  = sat.xgh4;
-    xh2   = sat.xh2;
-    xh3   = sat.xh3;
-    xi2   = sat.xi2;
-    xi3   = sat.xi3;
-    xl2   = sat.xl2;
-    xl3   = sat.xl3;
-    xl4   = sat.xl4;
-    zmol  = sat.zmol;
-    zmos  = sat.zmos;
+    xgh2  = sat.ds->xgh2;
+    xgh3  = sat.ds->xgh3;
+    xgh4  = sat.ds->xgh4;
+    xh2   = sat.ds->xh2;
+    xh3   = sat.ds->xh3;
+    xi2   = sat.ds->xi2;
+    xi3   = sat.ds->xi3;
+    xl2   = sat.ds->xl2;
+    xl3   = sat.ds->xl3;
+    xl4   = sat.ds->xl4;
+    zmol  = sat.ds->zmol;
+    zmos  = sat.ds->zmos;
 
     // ---------------------- constants -----------------------------
     zns = 1.19459e-5;
@@ -4,8 +4,11 @@
 #include "time.hpp"
 #include "tle.hpp"
 
+#include <algorithm>
 #include <iomanip>
+#include <memory>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 namespace iss_sgp4_json {
@@ -21,67 +24,27 @@ struct Const {
   double j4;
   double j3oj2;
 };
-// 衛星情報構造体
-struct Satellite {
-  // Unique satellite number given in the TLE file.
-  int    satnum     = 0;
-  // Full four-digit year of this element set's epoch moment.
-  int    epochyr    = 0;
-  // Fractional days into the year of the epoch moment.
-  double epochdays  = 0.0;
-  // Julian date of the epoch (computed from epochyr and epochdays).
-  double jdsatepoch = 0.0;
-  // First time derivative of the mean motion (ignored by SGP4).
-  double ndot       = 0.0;
-  // Second time derivative of the mean motion (ignored by SGP4).
-  double nddot      = 0.0;
-  // Ballistic drag coefficient B* in inverse earth radii.
-  double bstar      = 0.0;
-  // Inclination in radians.
-  double inclo      = 0.0;
-  // Right ascension of ascending node in radians.
-  double nodeo      = 0.0;
-  // Eccentricity.
-  double ecco       = 0.0;
-  // Argument of perigee in radians.
-  double argpo      = 0.0;
-  // Mean anomaly in radians.
-  double mo         = 0.0;
-  // Mean motion in radians per minute.
-  double no         = 0.0;
-  //
-  // Near Earth
-  char   method  = 'n';
-  char   opsmode = 'i';
-  char   init    = 'y';
-  int    isimp   = 0;
-  double aycof   = 0.0;
-  double con41   = 0.0;
-  double cc1     = 0.0;
-  double cc4     = 0.0;
-  double cc5     = 0.0;
-  double d2      = 0.0;
-  double d3      = 0.0;
-  double d4      = 0.0;
-  double delmo   = 0.0;
-  double eta     = 0.0;
-  double argpdot = 0.0;
-  double omgcof  = 0.0;
-  double sinmao  = 0.0;
-  double t       = 0.0;
-  double t2cof   = 0.0;
-  double t3cof   = 0.0;
-  double t4cof   = 0.0;
-  double t5cof   = 0.0;
-  double x1mth2  = 0.0;
-  double x7thm1  = 0.0;
-  double mdot    = 0.0;
-  double nodedot = 0.0;
-  double xlcof   = 0.0;
-  double xmcof   = 0.0;
-  double nodecf  = 0.0;
-  //
-  // Deep space
+// 重力モデル(gravconst)
+enum class Grav {
+  kWgs72Old,  // "wgs72old"
+  kWgs72,     // "wgs72"
+  kWgs84      // "wgs84"
+};
+// sgp4() の特殊化の種類（伝播方法）
+enum class Sgp4Mode {
+  kGeneric,   // 特殊化なし(method・isimp を実行時に判定)
+  kNear,      // 近地球(method == 'n', isimp == 0)
+  kNearSimp,  // 近地球・簡易抗力(method == 'n', isimp == 1)
+  kDeep       // 深宇宙(method == 'd')
+};
+// 深宇宙の共鳴項の積分の状態（チェックポイント; atime は番号から求める）
+struct DsCkpt {
+  double xli;
+  double xni;
+};
+// 衛星情報(深宇宙; method == 'd' の場合のみ)構造体
+// * 近地球の衛星では参照しないため、Satellite とは別に確保する
+struct SatDeep {
   int    irez  = 0;
   double d2201 = 0.0;
   double d2211 = 0.0;
@@ -120,7 +83,6 @@ struct Satellite {
   double sl2   = 0.0;
   double sl3   = 0.0;
   double sl4   = 0.0;
-  double gsto  = 0.0;
   double xfact = 0.0;
   double xgh2  = 0.0;
   double xgh3  = 0.0;
@@ -138,8 +100,109 @@ struct Satellite {
   double atime = 0.0;
   double xli   = 0.0;
   double xni   = 0.0;
+  // 共鳴項の積分のチェックポイント（irez != 0 の場合のみ）
+  // * j 番目は atime = ±(j + 1) * kDsCkpt * 720分 の状態
+  std::vector<DsCkpt> ck_p;  // 正の時刻
+  std::vector<DsCkpt> ck_n;  // 負の時刻
+};
+// 衛星情報(深宇宙)の保持
+// * method == 'd' の場合のみ確保する（近地球なら空）
+// * コピー時は中身を複製する（Satellite を値として扱えるように）
+class SatDeepPtr {
+  std::unique_ptr<SatDeep> p;
+
+public:
+  SatDeepPtr() = default;
+  SatDeepPtr(const SatDeepPtr& o)
+    : p(o.p ? std::make_unique<SatDeep>(*o.p) : nullptr) {}
+  SatDeepPtr(SatDeepPtr&&) = default;
+  SatDeepPtr& operator=(const SatDeepPtr& o) {
+    p = o.p ? std::make_unique<SatDeep>(*o.p) : nullptr;
+    return *this;
+  }
+  SatDeepPtr& operator=(SatDeepPtr&&) = default;
+  void alloc() { p = std::make_unique<SatDeep>(); }  // 確保(初期値)
+  void reset() { p.reset(); }                        // 解放
+  SatDeep* operator->() { return p.get(); }
+  const SatDeep* operator->() const { return p.get(); }
+  explicit operator bool() const { return static_cast<bool>(p); }
+};
+// 衛星情報構造体
+// * sgp4() が毎回参照する値(hot)を先頭にまとめ、初期化時のみ参照する値
+//   (cold)を後ろに、深宇宙の値を別領域(ds)に置く
+//   (多数の衛星を計算する際に、参照しない値をキャッシュへ載せないように)
+struct Satellite {
+  // ---- hot: sgp4() が毎回参照する ----
+  char   method  = 'n';
+  int    isimp   = 0;
   // error
-  int    error = 0;
+  int    error   = 0;
+  double t       = 0.0;
+  // Kepler 方程式の逐次解法（前回の解を初期値にする; 連続した計算用）
+  bool          kep_seq = false;  // 逐次解法の有無
+  double        kep_off = 0.0;    // 前回の解と平均経度の差(eo1 - u)
+  unsigned long kep_n   = 0;      // Kepler 方程式を解いた回数
+  unsigned long kep_itr = 0;      // 反復回数の合計
+  // Julian date of the epoch (computed from epochyr and epochdays).
+  double jdsatepoch = 0.0;
+  // Ballistic drag coefficient B* in inverse earth radii.
+  double bstar   = 0.0;
+  // Inclination in radians.
+  double inclo   = 0.0;
+  // Right ascension of ascending node in radians.
+  double nodeo   = 0.0;
+  // Eccentricity.
+  double ecco    = 0.0;
+  // Argument of perigee in radians.
+  double argpo   = 0.0;
+  // Mean anomaly in radians.
+  double mo      = 0.0;
+  // Mean motion in radians per minute.
+  double no      = 0.0;
+  //
+  // Near Earth
+  double aycof   = 0.0;
+  double con41   = 0.0;
+  double cc1     = 0.0;
+  double cc4     = 0.0;
+  double cc5     = 0.0;
+  double d2      = 0.0;
+  double d3      = 0.0;
+  double d4      = 0.0;
+  double delmo   = 0.0;
+  double eta     = 0.0;
+  double argpdot = 0.0;
+  double omgcof  = 0.0;
+  double sinmao  = 0.0;
+  double t2cof   = 0.0;
+  double t3cof   = 0.0;
+  double t4cof   = 0.0;
+  double t5cof   = 0.0;
+  double x1mth2  = 0.0;
+  double x7thm1  = 0.0;
+  double mdot    = 0.0;
+  double nodedot = 0.0;
+  double xlcof   = 0.0;
+  double xmcof   = 0.0;
+  double nodecf  = 0.0;
+  //
+  // ---- cold: 初期化時(・深宇宙)のみ参照する ----
+  // Unique satellite number given in the TLE file.
+  int    satnum     = 0;
+  // Full four-digit year of this element set's epoch moment.
+  int    epochyr    = 0;
+  // Fractional days into the year of the epoch moment.
+  double epochdays  = 0.0;
+  // First time derivative of the mean motion (ignored by SGP4).
+  double ndot       = 0.0;
+  // Second time derivative of the mean motion (ignored by SGP4).
+  double nddot      = 0.0;
+  char   opsmode    = 'i';
+  char   init       = 'y';
+  double gsto       = 0.0;
+  //
+  // Deep space (method == 'd' の場合のみ)
+  SatDeepPtr ds;
 };
 // 座標構造体
 struct Coord{
@@ -153,18 +216,35 @@ struct PvTeme {
   Coord v;  // 速度
 };
 
+class Sgp4;
+// SGP4 prediction model（重力モデル・伝播方法で特殊化したもの）
+using Sgp4Fn = PvTeme (Sgp4::*)(double, Satellite&);
+
+// 初期化済み衛星情報（キャッシュの1件分）
+struct SatCache {
+  Satellite     sat;       // 衛星情報
+  unsigned long used = 0;  // 最後に取得した順番(get_sat の通し番号)
+};
+
 class Sgp4 {
-  Const cst;  // 定数(gravconst)
+  Grav  grav;  // 重力モデル
+  Const cst;   // 定数(gravconst)
+  std::unordered_map<std::string, SatCache> sats;  // 初期化済み衛星情報(TLE 2行がキー)
+  unsigned long n_get = 0;                         // get_sat の呼び出し回数
 
 public:
-  Sgp4(struct timespec, std::vector<std::string>, std::string = "wgs84");
-                                                  // コンストラクタ
-  Satellite twoline2rv(bool afspc_mode = false);  // ISS 初期位置・速度の取得
-  PvTeme propagate(Satellite&);                   // 指定 UT1 の ISS 位置・速度の取得
+  Sgp4(std::string = "wgs84");                    // コンストラクタ
+  Satellite twoline2rv(
+      const std::vector<std::string>&, bool afspc_mode = false);
+                                                  // ISS 初期位置・速度の取得
+  Satellite& get_sat(const std::vector<std::string>&);
+                                                  // 初期化済み衛星情報の取得
+  PvTeme propagate(Satellite&, double);           // 元期から指定経過時間(分)の位置・速度の取得
+  PvTeme propagate(Satellite&, struct timespec);  // 指定 UT1 の ISS 位置・速度の取得
+  PvTeme propagate_spec(Satellite&, double);      // 同上(経過時間; 特殊化した sgp4() で計算)
+  const Const& get_const() const { return cst; }  // 定数(gravconst)
 
 private:
-  struct timespec ut1;               // UT1
-  std::vector<std::string> tle;      // TLE
   Const get_gravconst(std::string);  // 定数取得
   void sgp4init(Satellite&);         // SGP4 初期化
   void initl(
@@ -190,6 +270,12 @@ private:
       double&, double&, double&, double&, double&, double&, double&,
       Satellite&);                   // Deep space contributions 初期化
   PvTeme sgp4(double, Satellite&);   // SGP4 prediction model
+  template <class C, Sgp4Mode M>
+  PvTeme sgp4_k(double, Satellite&, const C&);
+                                     // SGP4 prediction model(定数・伝播方法で特殊化)
+  template <Grav G, Sgp4Mode M>
+  PvTeme sgp4_s(double, Satellite&); // SGP4 prediction model(重力モデル・伝播方法で特殊化)
+  Sgp4Fn dispatch(const Satellite&); // 特殊化した sgp4() の選択
   void dspace(
       double,
       double&, double&, double&, double&, double&, double&, double&,
@@ -0,0 +1,313 @@
+#include "sgp4_simd.hpp"
+
+#include "vmath.hpp"
+
+#include <cmath>
+
+namespace iss_sgp4_json {
+
+// 定数
+static constexpr int    kKtrMax = 10;                      // Kepler 反復回数の上限
+
+/*
+ * @brief      SGP4 近地球(method == 'n')の一括計算（kLanes 衛星分）
+ *             * Sgp4::sgp4() の近地球の分岐と同じ計算を、レーン毎のループ
+ *               (ベクトル化される)で行う
+ *             * isimp による分岐はレーン毎のマスク(選択)で行う
+ *             * Kepler 方程式の反復は、収束したレーンをマスクして全レーンが
+ *               収束するか上限回数に達するまで行う
+ *             * エラーコードはレーン毎に設定する
+ *               (1, 2, 4 なら位置・速度は 0; 6 なら位置・速度は計算値)
+ *             * 実行時に CPU に応じた命令セット(AVX-512/AVX2/既定)の版が
+ *               選択される
+ *
+ * @param[in]  定数 (Const)
+ * @param[in]  軌道要素 (NearLanes)
+ * @param[in]  元期からの経過時間(分; kLanes 個) (const double*)
+ * @param[out] 位置・速度 (PvLanes)
+ */
+__attribute__((target_clones("avx512f", "avx2", "default")))
+static void sgp4_near(
+    const Const& cst, const NearLanes& __restrict s,
+    const double* __restrict ts, PvLanes& __restrict pv) {
+  double t[kLanes];
+  double am[kLanes];
+  double nm[kLanes];
+  double axnl[kLanes];
+  double aynl[kLanes];
+  double u[kLanes];
+  double nodep[kLanes];
+  double eo1[kLanes];
+  double sineo1[kLanes];
+  double coseo1[kLanes];
+  double tem5[kLanes];
+  double err[kLanes];
+  double vkmpersec = cst.r * cst.xke / 60.0;
+  double any;
+  unsigned int l;
+  int          ktr;
+
+  // ---- update for secular gravity and atmospheric drag ----
+  // ---- long period periodics ----
+  for (l = 0; l < kLanes; ++l) {
+    double xmdf, argpdf, nodedf, argpm, mm, t2, t3, t4, nodem;
+    double tempa, tempe, templ, delomg, delmtemp, delm, temp;
+    double em, xlm, sinmm, cosmm, sinap, cosap, xl, smp;
+
+    t[l]   = ts[l];
+    xmdf   = s.mo[l] + s.mdot[l] * t[l];
+    argpdf = s.argpo[l] + s.argpdot[l] * t[l];
+    nodedf = s.nodeo[l] + s.nodedot[l] * t[l];
+    t2     = t[l] * t[l];
+    nodem  = nodedf + s.nodecf[l] * t2;
+    tempa  = 1.0 - s.cc1[l] * t[l];
+    tempe  = s.bstar[l] * s.cc4[l] * t[l];
+    templ  = s.t2cof[l] * t2;
+
+    // isimp != 1 の項（isimp == 1 のレーンは係数 smp = 0 で打ち消す）
+    v_sincos(xmdf, sinmm, cosmm);
+    delomg   = s.omgcof[l] * t[l];
+    delmtemp = 1.0 + s.eta[l] * cosmm;
+    delm     = s.xmcof[l] * (delmtemp * delmtemp * delmtemp - s.delmo[l]);
+    temp     = delomg + delm;
+    t3       = t2 * t[l];
+    t4       = t3 * t[l];
+    mm       = xmdf + temp;
+    v_sincos(mm, sinmm, cosmm);
+    smp    = 1.0 - s.simp[l];
+    mm     = s.simp[l] == 1.0 ? xmdf : mm;
+    argpm  = argpdf - smp * temp;
+    tempa -= smp * (s.d2[l] * t2 + s.d3[l] * t3 + s.d4[l] * t4);
+    tempe += smp * s.bstar[l] * s.cc5[l] * (sinmm - s.sinmao[l]);
+    templ += smp * (s.t3cof[l] * t3 + t4 * (s.t4cof[l] + t[l] * s.t5cof[l]));
+
+    // mean motion less than 0.0 (no > 0 は load で確認済み)
+    am[l] = s.ao[l] * tempa * tempa;
+    nm[l] = cst.xke / (am[l] * std::sqrt(am[l]));
+    em    = s.ecco[l] - tempe;
+
+    // fix tolerance for error recognition
+    err[l] = (em >= 1.0 || em < -0.001 || am[l] < 0.95) ? 1.0 : 0.0;
+
+    // sgp4fix fix tolerance to avoid a divide by zero
+    em  = em < 1.0e-6 ? 1.0e-6 : em;
+    mm += s.no[l] * templ;
+    xlm = mm + argpm + nodem;
+
+    nodem = v_fmod2pi(nodem);
+    argpm = v_fmod2pi(argpm);
+    xlm   = v_fmod2pi(xlm);
+    mm    = v_fmod2pi(xlm - argpm - nodem);
+    mm    = mm < 0.0 ? mm + kPi2 : mm;
+
+    // ---- long period periodics ----
+    v_sincos(argpm, sinap, cosap);
+    axnl[l]  = em * cosap;
+    temp     = 1.0 / (am[l] * (1.0 - em * em));
+    aynl[l]  = em * sinap + temp * s.aycof[l];
+    xl       = mm + argpm + nodem + temp * s.xlcof[l] * axnl[l];
+    nodep[l] = nodem;
+
+    // ---- solve kepler's equation (初期値) ----
+    u[l]    = v_fmod2pi(xl - nodem);
+    eo1[l]  = u[l];
+    tem5[l] = 9999.9;
+  }
+
+  // ---- solve kepler's equation ----
+  // sgp4fix for kepler iteration
+  // * 収束したレーン(|tem5| < 1e-12)は sin/cos・eo1 を更新しない
+  for (ktr = 1, any = 1.0; any > 0.0 && ktr <= kKtrMax; ++ktr) {
+    any = 0.0;
+    for (l = 0; l < kLanes; ++l) {
+      double sn, cs, d, on;
+
+      on = std::fabs(tem5[l]) >= 1.0e-12 ? 1.0 : 0.0;
+      v_sincos(eo1[l], sn, cs);
+      d  = 1.0 - cs * axnl[l] - sn * aynl[l];
+      d  = (u[l] - aynl[l] * cs + axnl[l] * sn - eo1[l]) / d;
+      d  = d >= 0.95 ? 0.95 : d <= -0.95 ? -0.95 : d;
+      sineo1[l] = on == 1.0 ? sn : sineo1[l];
+      coseo1[l] = on == 1.0 ? cs : coseo1[l];
+      tem5[l]   = on == 1.0 ? d : tem5[l];
+      eo1[l]   += on * d;
+      any      += on == 1.0 && std::fabs(d) >= 1.0e-12 ? 1.0 : 0.0;
+    }
+  }
+
+  // ---- short period preliminary quantities ----
+  // ---- orientation vectors ----
+  // ---- position and velocity (in km and km/sec) ----
+  for (l = 0; l < kLanes; ++l) {
+    double ecose, esine, el2, pl, rl, rdotl, rvdotl, betal, temp;
+    double sinu, cosu, su, sin2u, cos2u, temp1, temp2, mrt, xnode, xinc;
+    double mvt, rvdot, sinsu, cossu, snod, cnod, sini, cosi, xmx, xmy;
+    double ux, uy, uz, vx, vy, vz, mr, ok;
+
+    ecose = axnl[l] * coseo1[l] + aynl[l] * sineo1[l];
+    esine = axnl[l] * sineo1[l] - aynl[l] * coseo1[l];
+    el2   = axnl[l] * axnl[l] + aynl[l] * aynl[l];
+    pl    = am[l] * (1.0 - el2);
+    err[l] = err[l] == 0.0 && pl < 0.0 ? 4.0 : err[l];
+
+    rl     = am[l] * (1.0 - ecose);
+    rdotl  = std::sqrt(am[l]) * esine / rl;
+    rvdotl = std::sqrt(pl) / rl;
+    betal  = std::sqrt(1.0 - el2);
+    temp   = esine / (1.0 + betal);
+    sinu   = am[l] / rl * (sineo1[l] - aynl[l] - axnl[l] * temp);
+    cosu   = am[l] / rl * (coseo1[l] - axnl[l] + aynl[l] * temp);
+    su     = v_atan2(sinu, cosu);
+    sin2u  = (cosu + cosu) * sinu;
+    cos2u  = 1.0 - 2.0 * sinu * sinu;
+    temp   = 1.0 / pl;
+    temp1  = 0.5 * cst.j2 * temp;
+    temp2  = temp1 * temp;
+
+    // ---- update for short period periodics ----
+    mrt   = rl * (1.0 - 1.5 * temp2 * betal * s.con41[l])
+          + 0.5 * temp1 * s.x1mth2[l] * cos2u;
+    su   -= 0.25 * temp2 * s.x7thm1[l] * sin2u;
+    xnode = nodep[l] + 1.5 * temp2 * s.cosio[l] * sin2u;
+    xinc  = s.inclo[l] + 1.5 * temp2 * s.cosio[l] * s.sinio[l] * cos2u;
+    mvt   = rdotl - nm[l] * temp1 * s.x1mth2[l] * sin2u / cst.xke;
+    rvdot = rvdotl + nm[l] * temp1 * (s.x1mth2[l] * cos2u
+          + 1.5 * s.con41[l]) / cst.xke;
+
+    // ---- orientation vectors ----
+    v_sincos(su, sinsu, cossu);
+    v_sincos(xnode, snod, cnod);
+    v_sincos(xinc, sini, cosi);
+    xmx =  -snod * cosi;
+    xmy =   cnod * cosi;
+    ux  =  xmx * sinsu + cnod * cossu;
+    uy  =  xmy * sinsu + snod * cossu;
+    uz  =  sini * sinsu;
+    vx  =  xmx * cossu - cnod * sinsu;
+    vy  =  xmy * cossu - snod * sinsu;
+    vz  =  sini * cossu;
+
+    // ---- position and velocity (in km and km/sec) ----
+    // * エラー 1, 4 のレーンは 0
+    ok = err[l] == 0.0 ? 1.0 : 0.0;
+    mr = mrt * cst.r;
+    pv.rx[l] = ok == 1.0 ? mr * ux : 0.0;
+    pv.ry[l] = ok == 1.0 ? mr * uy : 0.0;
+    pv.rz[l] = ok == 1.0 ? mr * uz : 0.0;
+    pv.vx[l] = ok == 1.0 ? (mvt * ux + rvdot * vx) * vkmpersec : 0.0;
+    pv.vy[l] = ok == 1.0 ? (mvt * uy + rvdot * vy) * vkmpersec : 0.0;
+    pv.vz[l] = ok == 1.0 ? (mvt * uz + rvdot * vz) * vkmpersec : 0.0;
+
+    // sgp4fix for decaying satellites
+    err[l] = ok == 1.0 && mrt < 1.0 ? 6.0 : err[l];
+  }
+  for (l = 0; l < kLanes; ++l) { pv.err[l] = static_cast<int>(err[l]); }
+}
+
+/*
+ * @brief      コンストラクタ
+ *
+ * @param[in]  定数(gravconst) (Const)
+ */
+Sgp4Simd::Sgp4Simd(const Const& cst) : cst(cst) {}
+
+/*
+ * @brief      一括計算の対象か
+ *             * 近地球(method == 'n')で初期化エラーがなく、平均運動が正
+ *
+ * @param[in]  衛星情報 (Satellite)
+ * @return     対象なら true (bool)
+ */
+bool Sgp4Simd::is_near(const Satellite& sat) {
+  return sat.method == 'n' && sat.error == 0 && sat.no > 0.0;
+}
+
+/*
+ * @brief      軌道要素の設定
+ *             * 衛星情報(近地球; is_near が true)を構造体配列へ設定する
+ *             * 衛星数が kLanes 未満なら、残りのレーンは先頭の衛星で埋める
+ *
+ * @param[in]  衛星情報一覧 (const Satellite* const*)
+ * @param[in]  衛星数 (unsigned int; 1 .. kLanes)
+ * @param[out] 軌道要素 (NearLanes)
+ */
+void Sgp4Simd::load(
+    const Satellite* const* sats, unsigned int n, NearLanes& s) {
+  unsigned int l;
+
+  try {
+    s.n = n;
+    for (l = 0; l < kLanes; ++l) {
+      const Satellite& sat = *sats[l < n ? l : 0];
+      s.jdsatepoch[l] = sat.jdsatepoch;
+      s.mo[l]         = sat.mo;
+      s.mdot[l]       = sat.mdot;
+      s.argpo[l]      = sat.argpo;
+      s.argpdot[l]    = sat.argpdot;
+      s.nodeo[l]      = sat.nodeo;
+      s.nodedot[l]    = sat.nodedot;
+      s.nodecf[l]     = sat.nodecf;
+      s.cc1[l]        = sat.cc1;
+      s.cc4[l]        = sat.cc4;
+      s.cc5[l]        = sat.cc5;
+      s.bstar[l]      = sat.bstar;
+      s.t2cof[l]      = sat.t2cof;
+      s.t3cof[l]      = sat.t3cof;
+      s.t4cof[l]      = sat.t4cof;
+      s.t5cof[l]      = sat.t5cof;
+      s.omgcof[l]     = sat.omgcof;
+      s.eta[l]        = sat.eta;
+      s.xmcof[l]      = sat.xmcof;
+      s.delmo[l]      = sat.delmo;
+      s.d2[l]         = sat.d2;
+      s.d3[l]         = sat.d3;
+      s.d4[l]         = sat.d4;
+      s.sinmao[l]     = sat.sinmao;
+      s.simp[l]       = sat.isimp == 1 ? 1.0 : 0.0;
+      s.no[l]         = sat.no;
+      s.ecco[l]       = sat.ecco;
+      s.inclo[l]      = sat.inclo;
+      s.aycof[l]      = sat.aycof;
+      s.xlcof[l]      = sat.xlcof;
+      s.con41[l]      = sat.con41;
+      s.x1mth2[l]     = sat.x1mth2;
+      s.x7thm1[l]     = sat.x7thm1;
+      s.ao[l]         = pow(cst.xke / sat.no, 2.0 / 3.0);
+      s.sinio[l]      = sin(sat.inclo);
+      s.cosio[l]      = cos(sat.inclo);
+    }
+  } catch (...) {
+    throw;
+  }
+}
+
+/*
+ * @brief      元期から指定経過時間(分)の位置・速度の取得（kLanes 衛星分）
+ *             * Sgp4::propagate と 1 mm 以内で一致する
+ *
+ * @param[in]  軌道要素 (NearLanes)
+ * @param[in]  元期からの経過時間(分; kLanes 個) (const double*)
+ * @param[out] 位置・速度 (PvLanes)
+ */
+void Sgp4Simd::propagate(const NearLanes& s, const double* ts, PvLanes& pv) {
+  try {
+    sgp4_near(cst, s, ts, pv);
+  } catch (...) {
+    throw;
+  }
+}
+
+/*
+ * @brief      実行時に選択される命令セット
+ *             * sgp4_near の target_clones と同じ優先順で判定
+ *
+ * @return     命令セット名 (const char*)
+ */
+const char* Sgp4Simd::isa() {
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx512f")) { return "avx512f"; }
+  if (__builtin_cpu_supports("avx2")) { return "avx2"; }
+  return "default";
+}
+
+}  // namespace iss_sgp4_json
@@ -0,0 +1,80 @@
+#ifndef ISS_SGP4_JSON_SGP4_SIMD_HPP_
+#define ISS_SGP4_JSON_SGP4_SIMD_HPP_
+
+#include "sgp4.hpp"
+
+namespace iss_sgp4_json {
+
+static constexpr unsigned int kLanes = 8;  // 同時に計算する衛星数(レーン数)
+
+// 近地球衛星の軌道要素（構造体配列(SoA); kLanes 衛星分）
+// * 各配列の l 番目が l 番目のレーン(衛星)の値
+// * sgp4init で初期化済みの値のうち、近地球(method == 'n')の sgp4() が
+//   参照するもの（ao, sinio, cosio は計算毎に不変な値の事前計算）
+struct alignas(64) NearLanes {
+  double jdsatepoch[kLanes];
+  double mo[kLanes];
+  double mdot[kLanes];
+  double argpo[kLanes];
+  double argpdot[kLanes];
+  double nodeo[kLanes];
+  double nodedot[kLanes];
+  double nodecf[kLanes];
+  double cc1[kLanes];
+  double cc4[kLanes];
+  double cc5[kLanes];
+  double bstar[kLanes];
+  double t2cof[kLanes];
+  double t3cof[kLanes];
+  double t4cof[kLanes];
+  double t5cof[kLanes];
+  double omgcof[kLanes];
+  double eta[kLanes];
+  double xmcof[kLanes];
+  double delmo[kLanes];
+  double d2[kLanes];
+  double d3[kLanes];
+  double d4[kLanes];
+  double sinmao[kLanes];
+  double simp[kLanes];    // isimp == 1 なら 1.0, それ以外は 0.0
+  double no[kLanes];
+  double ecco[kLanes];
+  double inclo[kLanes];
+  double aycof[kLanes];
+  double xlcof[kLanes];
+  double con41[kLanes];
+  double x1mth2[kLanes];
+  double x7thm1[kLanes];
+  double ao[kLanes];      // pow(xke / no, 2/3)
+  double sinio[kLanes];   // sin(inclo)
+  double cosio[kLanes];   // cos(inclo)
+  unsigned int n = 0;     // 有効なレーン数
+};
+
+// 位置・速度（構造体配列(SoA); kLanes 衛星分）
+struct alignas(64) PvLanes {
+  double rx[kLanes];   // 位置(TEME; x; km)
+  double ry[kLanes];   // 位置(TEME; y; km)
+  double rz[kLanes];   // 位置(TEME; z; km)
+  double vx[kLanes];   // 速度(TEME; x; km/s)
+  double vy[kLanes];   // 速度(TEME; y; km/s)
+  double vz[kLanes];   // 速度(TEME; z; km/s)
+  int    err[kLanes];  // エラーコード(Satellite::error と同じ)
+};
+
+class Sgp4Simd {
+  Const cst;  // 定数(gravconst)
+
+public:
+  Sgp4Simd(const Const&);                       // コンストラクタ
+  static bool is_near(const Satellite&);        // 一括計算の対象か
+  void load(const Satellite* const*, unsigned int, NearLanes&);
+                                                // 軌道要素の設定
+  void propagate(const NearLanes&, const double*, PvLanes&);
+                                                // 元期から指定経過時間(分)の位置・速度の取得
+  static const char* isa();                     // 実行時に選択される命令セット
+};
+
+}  // namespace iss_sgp4_json
+
+#endif
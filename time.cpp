@@ -2,10 +2,9 @@
 
 namespace iss_sgp4_json {
 
-static constexpr char         kFEop[]    = "eop.txt";
-static constexpr char         kFDat[]    = "Leap_Second.dat";
 static constexpr double       kE9        = 1.0e9;
-static constexpr double       kEm6       = 1.0e-6;
+static constexpr long         kNsMs      = 1000000;          // ナノ秒(1ミリ秒分)
+static constexpr long long    kNsS       = 1000000000;       // ナノ秒(1秒分)
 static constexpr double       kPi        = atan(1.0) * 4.0;  // 円周率
 static constexpr double       kPi2       = kPi * 2.0;        // 円周率 * 2
 static constexpr double       kDeg2Rad   = kPi / 180.0;      // 0.0174532925199433
@@ -13,6 +12,17 @@ static constexpr double       kJstOffset = 32400.0;          //  9 * 60 * 60
 static constexpr double       kTtTai     = 32.184;           // TT - TAI
 static constexpr unsigned int kJ2k       = 2451545;          // Julian Day of 2000-01-01 12:00:00
 static constexpr unsigned int kDayJc     = 36525;            // Days per Julian century
+static constexpr int          kDays0Unix = 719468;           // Days from 0000-03-01 to 1970-01-01
+static constexpr int          kMjdUnix   = 40587;            // MJD of 1970-01-01
+static constexpr double       kJdUnix    = 2440587.5;        // Julian Day of 1970-01-01 00:00:00
+static constexpr long         kSecD      = 86400;            // Seconds per day
+
+// 内部関数
+static int days_from_civil(int, unsigned int, unsigned int);  // 年月日 => 1970-01-01 からの通日
+static void civil_from_days(int, int&, unsigned int&, unsigned int&);
+                                                               // 1970-01-01 からの通日 => 年月日
+static int days_from_ts(struct timespec);                     // 日時 => 1970-01-01 からの通日
+static char* put_uint(char*, unsigned long, unsigned int);    // 整数 => 0 埋め文字列
 
 /*
  * @brief      日時文字列生成
@@ -21,28 +31,63 @@ static constexpr unsigned int kDayJc     = 36525;            // Days per Julian
  * @return     日時文字列 (string)
  */
 std::string gen_time_str(struct timespec ts) {
-  struct tm t;
-  std::stringstream ss;
-  std::string str_tm;
+  char buf[kTimeStrMax];
 
   try {
-    localtime_r(&ts.tv_sec, &t);
-    ss << std::setfill('0')
-       << std::setw(4) << t.tm_year + 1900 << "-"
-       << std::setw(2) << t.tm_mon + 1     << "-"
-       << std::setw(2) << t.tm_mday        << " "
-       << std::setw(2) << t.tm_hour        << ":"
-       << std::setw(2) << t.tm_min         << ":"
-       << std::setw(2) << t.tm_sec         << "."
-       << std::setw(3) << round(ts.tv_nsec * kEm6);
-    return ss.str();
+    return std::string(buf, put_time_str(ts, buf));
   } catch (...) {
     throw;
   }
 }
 
+/*
+ * @brief      日時文字列生成（バッファへ書き込み）
+ *             * 書式: YYYY-MM-DD HH:MM:SS.mmm（ミリ秒は四捨五入; 秒以上へ繰り上げる）
+ *             * 文字列ストリーム・メモリ確保を使用しない
+ *
+ * @param[in]  日時 (timespec)
+ * @param[out] バッファ (char*; kTimeStrMax 文字以上)
+ * @return     書き込んだ文字数 (size_t)
+ */
+size_t put_time_str(struct timespec ts, char* buf) {
+  int          days;
+  int          y;
+  unsigned int m;
+  unsigned int d;
+  long         sec;
+  long         ms;   // ミリ秒(四捨五入後)
+  char*        p = buf;
+
+  // ミリ秒への四捨五入（1000 ミリ秒になれば秒へ繰り上げる）
+  ms = (ts.tv_nsec + kNsMs / 2) / kNsMs;
+  if (ms >= 1000) {
+    ++ts.tv_sec;
+    ms -= 1000;
+  }
+  days = days_from_ts(ts);
+  sec  = ts.tv_sec - static_cast<time_t>(days) * kSecD;
+  civil_from_days(days, y, m, d);
+  p = put_uint(p, y, 4);
+  *p++ = '-';
+  p = put_uint(p, m, 2);
+  *p++ = '-';
+  p = put_uint(p, d, 2);
+  *p++ = ' ';
+  p = put_uint(p, sec / 3600, 2);
+  *p++ = ':';
+  p = put_uint(p, sec % 3600 / 60, 2);
+  *p++ = ':';
+  p = put_uint(p, sec % 60, 2);
+  *p++ = '.';
+  p = put_uint(p, static_cast<unsigned long>(ms), 3);
+
+  return p - buf;
+}
+
 /*
  * @brief      時刻 + 秒数
+ *             * 秒数は整数部・小数部に分けて加算する（int に収まらない秒数も
+ *               可; tv_nsec の繰り上がり・繰り下がりは除算で求める）
  *
  * @param[in]  時刻 (timespec)
  * @param[in]  秒数 (double)
@@ -50,18 +95,21 @@ std::string gen_time_str(struct timespec ts) {
  */
 struct timespec ts_add(struct timespec ts_src, double s) {
   struct timespec ts;
+  double          s_i;  // 秒数の整数部
+  long long       ns;   // ナノ秒(繰り上がり・繰り下がり前)
+  long long       c;    // 繰り上がり(秒)
 
   try {
-    ts.tv_sec  = ts_src.tv_sec + int(s);
-    ts.tv_nsec = ts_src.tv_nsec + (s - int(s)) * kE9;
-    while (ts.tv_nsec > kE9) {
-      ++ts.tv_sec;
-      ts.tv_nsec -= kE9;
-    }
-    while (ts.tv_nsec < 0) {
-      --ts.tv_sec;
-      ts.tv_nsec += kE9;
+    s_i = std::trunc(s);
+    ns  = static_cast<long long>(ts_src.tv_nsec + (s - s_i) * kE9);
+    c   = ns / kNsS;
+    ns -= c * kNsS;
+    if (ns < 0) {
+      --c;
+      ns += kNsS;
     }
+    ts.tv_sec  = ts_src.tv_sec + static_cast<time_t>(s_i) + c;
+    ts.tv_nsec = ns;
   } catch (...) {
     throw;
   }
@@ -170,84 +218,6 @@ double gstime(double jdut1) {
   return gst;
 }
 
-/*
- * @brief      DUT1 取得 (EOP 読み込み)
- *
- * @param<in>  UTC (timespec)
- * @return     DUT1 (double)
- */
-double get_dut1(struct timespec ts) {
-  std::string f(kFEop);    // ファイル名
-  std::string str_utc;     // 対象の UTC 文字列
-  std::string eop;         // 1行分バッファ
-  double      dut1 = 0.0;  // DUT1
-
-  try {
-    // 対象の UTC 年月日
-    str_utc = gen_time_str(ts).substr(0, 10);
-
-    // ファイル OPEN
-    std::ifstream ifs(f);
-    if (!ifs) throw;  // 読み込み失敗
-
-    // ファイル READ
-    while (getline(ifs, eop)) {
-      if (eop.substr(0, 10) == str_utc) { break; }
-    }
-
-    // DUT1 取得
-    dut1 = stod(eop.substr(62, 10));
-  } catch (...) {
-    throw;
-  }
-
-  return dut1;
-}
-
-/*
- * @brief      DAT (= TAI - UTC)（うるう秒の総和）取得
- *
- * @param<in>  UTC (timespec)
- * @return     DAT (int)
- */
-unsigned int get_dat(struct timespec ts) {
-  std::string  f(kFDat);   // ファイル名
-  std::string  str_utc;    // 対象の UTC 文字列
-  std::string  str_wk;     // UTC 文字列（作業用）
-  std::string  buf;        // 1行分バッファ
-  std::string  ls;         // 該当行
-  unsigned int dat = 0.0;  // DUT1
-
-  try {
-    // 対象の UTC 年月日
-    str_utc = gen_time_str(ts);
-
-    // ファイル OPEN
-    std::ifstream ifs(f);
-    if (!ifs) throw;  // 読み込み失敗
-
-    // ファイル READ
-    while (getline(ifs, buf)) {
-      if (buf.substr(0, 1) == "#") { continue; }
-      std::stringstream ss;
-      ss << std::setfill('0')
-         << std::setw(4) << stoi(buf.substr(20, 4)) << "-"
-         << std::setw(2) << stoi(buf.substr(17, 2)) << "-"
-         << std::setw(2) << stoi(buf.substr(14, 2));
-      str_wk = ss.str();
-      if (str_utc < str_wk) { break; }
-      ls = buf;
-    }
-
-    // DAT 取得
-    dat = stoi(ls.substr(31, 2));
-  } catch (...) {
-    throw;
-  }
-
-  return dat;
-}
-
 /*
  * @brief      JST -> UTC
  *
@@ -269,15 +239,14 @@ struct timespec jst2utc(struct timespec jst) {
 /*
  * @brief      UTC -> UT1
  *
- * @param[in]  UTC (timespec)
- * @return     UT1 (timespec)
+ * @param[in]  UTC  (timespec)
+ * @param[in]  DUT1 (double)
+ * @return     UT1  (timespec)
  */
-struct timespec utc2ut1(struct timespec utc) {
-  double dut1;
+struct timespec utc2ut1(struct timespec utc, double dut1) {
   struct timespec ut1;
 
   try {
-    dut1 = get_dut1(utc);
     ut1 = ts_add(utc, dut1);
   } catch (...) {
     throw;
@@ -290,14 +259,13 @@ struct timespec utc2ut1(struct timespec utc) {
  * @brief      UTC -> TAI
  *
  * @param[in]  UTC (timespec)
+ * @param[in]  DAT (= TAI - UTC) (int)
  * @return     TAI (timespec)
  */
-struct timespec utc2tai(struct timespec utc) {
-  int dat;
+struct timespec utc2tai(struct timespec utc, int dat) {
   struct timespec tai;
 
   try {
-    dat = get_dat(utc);
     tai = ts_add(utc, dat);
   } catch (...) {
     throw;
@@ -326,49 +294,21 @@ struct timespec tai2tt(struct timespec tai) {
 
 /*
  * @brief      Gregrorian Calendar -> Julian Day
+ *             * 2分割のユリウス日を1つにまとめたもの（精度は ts2jd の方が高い）
  *
  * @param[in]  GC (timespec)
  * @return     JD (double)
  */
 double gc2jd(struct timespec ts) {
-  struct tm t;
-  unsigned int year;
-  unsigned int month;
-  unsigned int day;
-  unsigned int hour;
-  unsigned int min;
-  unsigned int sec;
-  double jd;
+  JulianDay jd;
 
   try {
-    localtime_r(&ts.tv_sec, &t);
-    year  = t.tm_year + 1900;
-    month = t.tm_mon + 1;
-    day   = t.tm_mday;
-    hour  = t.tm_hour;
-    min   = t.tm_min;
-    sec   = t.tm_sec;
-    // 1月,2月は前年の13月,14月とする
-    if (month < 3) {
-      --year;
-      month += 12;
-    }
-    // 日付(整数)部分
-    jd = static_cast<int>(365.25 * year)
-       + static_cast<int>(year / 400.0)
-       - static_cast<int>(year / 100.0)
-       + static_cast<int>(30.59 * (month - 2))
-       + day
-       + 1721088.5;
-    // 時間(小数)部分
-    jd += (sec / 3600.0 + min / 60.0 + hour) / 24.0;
-    // 時間(ナノ秒)部分
-    jd += ts.tv_nsec / 1000000000.0 / 3600.0 / 24.0;
+    jd = ts2jd(ts);
   } catch (...) {
     throw;
   }
 
-  return jd;
+  return jd.jd + jd.fr;
 }
 
 /*
@@ -389,5 +329,164 @@ double jd2jcn(double jd) {
   return jcn;
 }
 
-}  // namespace iss_sgp4_json
+/*
+ * @brief      日時 -> MJD(日単位)
+ *
+ * @param[in]  日時 (timespec)
+ * @return     MJD (unsigned int)
+ */
+unsigned int ts2mjd(struct timespec ts) {
+  return days_from_ts(ts) + kMjdUnix;
+}
+
+/*
+ * @brief      MJD(日単位) -> 日時
+ *
+ * @param[in]  MJD (unsigned int)
+ * @return     日時(00:00:00) (timespec)
+ */
+struct timespec mjd2ts(unsigned int mjd) {
+  struct timespec ts;
+
+  ts.tv_sec  = (static_cast<time_t>(mjd) - kMjdUnix) * kSecD;
+  ts.tv_nsec = 0;
 
+  return ts;
+}
+
+/*
+ * @brief      日時 -> ユリウス日(2分割)
+ *             * 文字列変換・タイムゾーン参照・メモリ確保を行わず、
+ *               1970-01-01 からの通日と日の小数部に分けて計算する
+ *
+ * @param[in]  日時 (timespec)
+ * @return     ユリウス日 (JulianDay)
+ */
+JulianDay ts2jd(struct timespec ts) {
+  int       days;
+  JulianDay jd;
+
+  days  = days_from_ts(ts);
+  jd.jd = kJdUnix + days;
+  jd.fr = ((ts.tv_sec - static_cast<time_t>(days) * kSecD)
+        + ts.tv_nsec * 1.0e-9) / kSecD;
+
+  return jd;
+}
+
+/*
+ * @brief      年月日時分秒 -> 日時
+ *
+ * @param[in]  日時 (DateTime)
+ * @return     日時 (timespec)
+ */
+struct timespec dt2ts(DateTime dt) {
+  double          sec;
+  struct timespec ts;
+
+  try {
+    sec = floor(dt.second);
+    ts.tv_sec  = static_cast<time_t>(days_from_civil(dt.year, dt.month, dt.day))
+               * kSecD + dt.hour * 3600 + dt.minute * 60
+               + static_cast<time_t>(sec);
+    ts.tv_nsec = round((dt.second - sec) * kE9);
+  } catch (...) {
+    throw;
+  }
+
+  return ts;
+}
+
+/********************************************
+ **** 以下、 private function/procedures ****
+ ********************************************/
+
+/*
+ * @brief      年月日 => 1970-01-01 からの通日
+ *             * 3月始まりの年で 0000-03-01 からの通日を計算
+ *
+ * @param[in]  年 (int)
+ * @param[in]  月 (unsigned int)
+ * @param[in]  日 (unsigned int)
+ * @return     通日 (int)
+ */
+static int days_from_civil(int y, unsigned int m, unsigned int d) {
+  int          era;
+  unsigned int yoe;
+  unsigned int doy;
+  unsigned int doe;
+
+  if (m <= 2) { --y; }
+  era = (y >= 0 ? y : y - 399) / 400;
+  yoe = static_cast<unsigned int>(y - era * 400);
+  doy = (153 * (m > 2 ? m - 3 : m + 9) + 2) / 5 + d - 1;
+  doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+
+  return era * 146097 + static_cast<int>(doe) - kDays0Unix;
+}
+
+/*
+ * @brief      1970-01-01 からの通日 => 年月日
+ *
+ * @param[in]   通日 (int)
+ * @param[out]  年 (int)
+ * @param[out]  月 (unsigned int)
+ * @param[out]  日 (unsigned int)
+ */
+static void civil_from_days(
+    int days, int& y, unsigned int& m, unsigned int& d) {
+  int          era;
+  unsigned int doe;
+  unsigned int yoe;
+  unsigned int doy;
+  unsigned int mp;
+
+  days += kDays0Unix;
+  era = (days >= 0 ? days : days - 146096) / 146097;
+  doe = static_cast<unsigned int>(days - era * 146097);
+  yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+  doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+  mp  = (5 * doy + 2) / 153;
+  d   = doy - (153 * mp + 2) / 5 + 1;
+  m   = mp < 10 ? mp + 3 : mp - 9;
+  y   = static_cast<int>(yoe) + era * 400 + (m <= 2 ? 1 : 0);
+}
+
+/*
+ * @brief      日時 => 1970-01-01 からの通日
+ *
+ * @param[in]  日時 (timespec)
+ * @return     通日 (int)
+ */
+static int days_from_ts(struct timespec ts) {
+  time_t days;
+
+  days = ts.tv_sec / kSecD;
+  if (ts.tv_sec % kSecD < 0) { --days; }
+
+  return static_cast<int>(days);
+}
+
+/*
+ * @brief      整数 => 0 埋め文字列
+ *
+ * @param[out] 書き込み位置 (char*)
+ * @param[in]  値 (unsigned long)
+ * @param[in]  最小桁数 (unsigned int)
+ * @return     書き込み後の位置 (char*)
+ */
+static char* put_uint(char* p, unsigned long v, unsigned int w) {
+  char         tmp[24];
+  unsigned int n = 0;
+
+  do {
+    tmp[n++] = '0' + v % 10;
+    v /= 10;
+  } while (v > 0);
+  while (n < w) { tmp[n++] = '0'; }
+  while (n > 0) { *p++ = tmp[--n]; }
+
+  return p;
+}
+
+}  // namespace iss_sgp4_json
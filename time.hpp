@@ -12,6 +12,8 @@
 
 namespace iss_sgp4_json {
 
+// ※ 日時(timespec)は、各時刻系(JST, UTC, UT1, TAI, TT)の年月日時分秒を
+//    1970-01-01 00:00:00 からの経過秒で表したもの（タイムゾーンは参照しない）
 struct DateTime {
   unsigned int year;
   unsigned int month;
@@ -20,20 +22,30 @@ struct DateTime {
   unsigned int minute;
   double       second ;
 };
+// ユリウス日(2分割)構造体
+struct JulianDay {
+  double jd;  // 0時のユリウス日(端数 .5)
+  double fr;  // 日の小数部
+};
+
+static constexpr size_t kTimeStrMax = 48;         // 日時文字列の最大長
 
 std::string gen_time_str(struct timespec ts);     // 日時文字列生成
+size_t put_time_str(struct timespec, char*);      // 日時文字列生成（バッファへ書き込み）
 struct timespec ts_add(struct timespec, double);  // 時刻 + 秒数
 DateTime days2ymdhms(unsigned int, double);       // 年+経過日数 => 年月日時分秒
 double jday(DateTime);                            // 年月日時分秒 => ユリウス日
 double gstime(double);                            // Greenwich sidereal time calculation
-double get_dut1(struct timespec);                 // DUT1 取得(EOP 読み込み)
-unsigned int get_dat(struct timespec);            // DAT (= TAI - UTC)（うるう秒総和）取得
 struct timespec jst2utc(struct timespec);         // JST -> UTC
-struct timespec utc2ut1(struct timespec);         // UTC -> UT1
-struct timespec utc2tai(struct timespec);         // UTC -> TAI
+struct timespec utc2ut1(struct timespec, double); // UTC -> UT1
+struct timespec utc2tai(struct timespec, int);    // UTC -> TAI
 struct timespec tai2tt(struct timespec);          // TAI -> TT
 double gc2jd(struct timespec);                    // Gregorian Calendar -> Julian Day
 double jd2jcn(double);                            // Julian Day -> Julian Century Number
+unsigned int ts2mjd(struct timespec);             // 日時 -> MJD(日単位)
+struct timespec mjd2ts(unsigned int);             // MJD(日単位) -> 日時
+JulianDay ts2jd(struct timespec);                 // 日時 -> ユリウス日(2分割)
+struct timespec dt2ts(DateTime);                  // 年月日時分秒 -> 日時
 
 }  // namespace iss_sgp4_json
 
@@ -1,89 +1,138 @@
 #include "tle.hpp"
 
+#include "prof.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+#include <limits>
+
 namespace iss_sgp4_json {
 
 // 定数
-static constexpr char         kFTle[] = "tle.txt";
 static constexpr unsigned int kSecDay =  86400;  // Seconds in a day
 
 /*
  * @brief      コンストラクタ
+ *             * TLE ファイルを読み込み、元期付きの TLE 一覧を保持する
+ *
+ * @param[in]  TLE ファイル名 (string; optional)
+ */
+Tle::Tle(std::string f) {
+  ProfTimer pt(Stage::kTle);
+
+  load(f);
+  if (recs.size() == 0) {
+    std::cerr << "[ERROR] TLE data could not be found!" << std::endl;
+    std::exit(EXIT_FAILURE);
+  }
+}
+
+/*
+ * @brief      TLE 検索
+ *             * 指定 UT1 以前で最新の元期の TLE を二分探索で取得する
+ *             * 指定 UT1 が最初の元期より前なら最初の TLE、
+ *               最後の元期より後なら最後の TLE
+ *
+ * @param[in]  UT1 (timespec)
+ * @return     TLE(2行) (vector<string>)
+ */
+const std::vector<std::string>& Tle::get_tle(struct timespec ut1) {
+  std::vector<TleRec>::const_iterator it;
+
+  try {
+    // 元期(秒)が UT1(秒) より後となる最初の TLE
+    it = std::upper_bound(recs.cbegin(), recs.cend(), ut1.tv_sec,
+        [](time_t sec, const TleRec& rec) {
+          return sec < rec.epoch.tv_sec;
+        });
+    if (it != recs.cbegin()) { --it; }
+  } catch (...) {
+    throw;
+  }
+
+  return it->tle;
+}
+
+/*
+ * @brief      次の TLE 切り替え日時
+ *             * 指定 UT1 より後で get_tle の結果が変わり得る最初の元期
+ *             * UT1(秒) がこの元期(秒)に達するまでは同じ TLE となる
+ *             * 以降に元期がなければ time_t の最大値
  *
  * @param[in]  UT1 (timespec)
+ * @return     元期 (timespec)
  */
-Tle::Tle(struct timespec ut1) {
-  this->ut1 = ut1;
+struct timespec Tle::next_epoch(struct timespec ut1) {
+  std::vector<TleRec>::const_iterator it;
+  struct timespec ts = {std::numeric_limits<time_t>::max(), 0};
+
+  try {
+    it = std::upper_bound(recs.cbegin(), recs.cend(), ut1.tv_sec,
+        [](time_t sec, const TleRec& rec) {
+          return sec < rec.epoch.tv_sec;
+        });
+    if (it != recs.cend()) { ts = it->epoch; }
+  } catch (...) {
+    throw;
+  }
+
+  return ts;
 }
 
+/********************************************
+ **** 以下、 private function/procedures ****
+ ********************************************/
+
 /*
- * @brief   TLE 読み込み
+ * @brief      TLE 読み込み
+ *             * 1行目の元期を計算し、元期の昇順に並べて保持する
  *
- * @param   <none>
- * @return  TLE(2行) (vector<string>)
+ * @param[in]  TLE ファイル名 (string)
+ * @return     <none>
  */
-std::vector<std::string> Tle::get_tle() {
-  std::string              f(kFTle);  // ファイル名
-  std::vector<std::string> data;      // TLE 一覧（全データ）
-  struct tm                t;         // 時刻構造体
+void Tle::load(std::string f) {
   std::string              buf;       // 1行分バッファ
-  std::vector<std::string> tle_p(2);  // TLE（退避用）
+  std::vector<std::string> tle(2);    // TLE（作業用）
   unsigned int             y;         // year
   double                   d;         // day
-  struct timespec          utc;       // UTC
-  unsigned int             i;         // loop index
-  std::vector<std::string> tle(2, "");  // TLE
+  TleRec                   rec;       // TLE レコード
 
   try {
     // ファイル OPEN
     std::ifstream ifs(f);
-    if (!ifs) throw;  // 読み込み失敗
-
-    // ファイル READ（一旦、全て読み込む）
-    while (getline(ifs, buf)) {
-      //std::vector<std::string> rec;  // 1行分ベクタ
-      std::istringstream iss(buf);   // 文字列ストリーム
-      if (buf.substr(0, 1) != "1" && buf.substr(0, 1) != "2") { continue; }
-      data.push_back(buf);
+    if (!ifs) {
+      std::cerr << "[ERROR] " << f << " could not be opened!" << std::endl;
+      std::exit(EXIT_FAILURE);
     }
 
-    // 最新 TLE 検索
-    for (auto l: data) {
-      if (l.substr(0, 1) == "1") {
-        y = 2000 + stoi(l.substr(18, 2));
-        d = stod(l.substr(20, 12));
-        // y 年の 01-01 00:00:00
-        std::stringstream ss;
-        ss << std::setfill('0')
-           << std::setw(4) << y
-           << std::setw(2) << 1
-           << std::setw(2) << 1
-           << std::setw(2) << 0
-           << std::setw(2) << 0
-           << std::setw(2) << 0;
-        std::istringstream is(ss.str());
-        is >> std::get_time(&t, "%Y%m%d%H%M%S");
-        utc.tv_sec = mktime(&t);
-        utc.tv_nsec = 0;
-        // utc = y 年の 01-01 00:00:00 に経過日数 d を加算した日時
-        utc = ts_add(utc, d * kSecDay);
-        if (utc.tv_sec > ut1.tv_sec) {
-          tle = tle_p;
-          break;
-        }
+    // ファイル READ（2行目を読んだ時点で1件とする）
+    while (getline(ifs, buf)) {
+      if (buf.substr(0, 1) == "1") {
+        tle[0] = buf;
+        continue;
       }
-      tle_p[stoi(l.substr(0, 1)) - 1] = l;
+      if (buf.substr(0, 1) != "2" || tle[0] == "") { continue; }
+      tle[1] = buf;
+      y = 2000 + stoi(tle[0].substr(18, 2));
+      d = stod(tle[0].substr(20, 12));
+      // y 年の 01-01 00:00:00
+      rec.epoch = dt2ts({y, 1, 1, 0, 0, 0.0});
+      // y 年の 01-01 00:00:00 に経過日数 d を加算した日時
+      // (d は1月1日 00:00:00 を 1.0 とする通日)
+      rec.epoch = ts_add(rec.epoch, (d - 1.0) * kSecDay);
+      rec.tle   = tle;
+      recs.push_back(rec);
+      tle[0] = "";
     }
 
-    // 上記の処理で該当レコードが得られなかった場合は、最初の2行
-    if (tle[0] == "") {
-      for (i = 0; i < 2; ++i) { tle[i] = data[i]; }
-    }
+    // 元期の昇順（同一元期はファイル記載順）
+    std::stable_sort(recs.begin(), recs.end(),
+        [](const TleRec& a, const TleRec& b) {
+          return a.epoch.tv_sec < b.epoch.tv_sec;
+        });
   } catch (...) {
     throw;
   }
-
-  return tle;
 }
 
 }  // namespace iss_sgp4_json
-
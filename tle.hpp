@@ -12,17 +12,25 @@
 
 namespace iss_sgp4_json {
 
+// TLE レコード構造体
+struct TleRec {
+  struct timespec          epoch;  // 元期
+  std::vector<std::string> tle;    // TLE(2行)
+};
+
 class Tle {
+  std::vector<TleRec> recs;  // TLE 一覧（元期順）
+
 public:
-  std::vector<std::string> tle;        // TLE
-  Tle(struct timespec);                // コンストラクタ
-  std::vector<std::string> get_tle();  // TLE 読み込み
+  Tle(std::string = "tle.txt");  // コンストラクタ
+  const std::vector<std::string>& get_tle(struct timespec);  // TLE 検索
+  struct timespec next_epoch(struct timespec);  // 次の TLE 切り替え日時
+  unsigned int size() { return recs.size(); }  // TLE 件数
 
 private:
-  struct timespec ut1;  // UT1
+  void load(std::string);  // TLE 読み込み
 };
 
 }  // namespace iss_sgp4_json
 
 #endif
-
@@ -0,0 +1,127 @@
+#ifndef ISS_SGP4_JSON_VMATH_HPP_
+#define ISS_SGP4_JSON_VMATH_HPP_
+
+#include <cmath>
+
+// 分岐を持たない数学関数（SIMD カーネル用）
+// * レーン毎・要素毎のループ内でベクトル化されるよう、分岐を選択(?:)で書く
+//   (libm の sin/cos/atan2/fmod/cbrt はベクトル化されないため)
+// * ベクトル化用のオプション(Makefile の simd_options)でコンパイルする
+//   ソースからのみ include する
+
+namespace iss_sgp4_json {
+
+// 定数
+static constexpr double kPi     = 3.14159265358979323846;  // 円周率
+static constexpr double kPi2    = kPi * 2.0;               // 円周率 * 2
+static constexpr double kPiH    = kPi / 2.0;               // 円周率 / 2
+static constexpr double kPiQ    = kPi / 4.0;               // 円周率 / 4
+static constexpr double kTanPi8 = 0.41421356237309504880;  // tan(π/8)
+static constexpr double kRound  = 6755399441055744.0;      // 2^52 + 2^51(丸め用)
+// π/2 の分割(fdlibm)
+static constexpr double kPio2_1 = 1.57079632673412561417e+00;
+static constexpr double kPio2_2 = 6.07710050630396597660e-11;
+static constexpr double kPio2_3 = 2.02226624871116645580e-21;
+static constexpr double k2oPi   = 6.36619772367581382433e-01;
+// sin/cos 多項式係数(fdlibm; |x| <= π/4)
+static constexpr double kS1 = -1.66666666666666324348e-01;
+static constexpr double kS2 =  8.33333333332248946124e-03;
+static constexpr double kS3 = -1.98412698298579493134e-04;
+static constexpr double kS4 =  2.75573137070700676789e-06;
+static constexpr double kS5 = -2.50507602534068634195e-08;
+static constexpr double kS6 =  1.58969099521155010221e-10;
+static constexpr double kC1 =  4.16666666666666019037e-02;
+static constexpr double kC2 = -1.38888888888741095749e-03;
+static constexpr double kC3 =  2.48015872894767294178e-05;
+static constexpr double kC4 = -2.75573143513906633035e-07;
+static constexpr double kC5 =  2.08757232129817482790e-09;
+static constexpr double kC6 = -1.13596475577881948265e-11;
+// atan 多項式係数(fdlibm; |x| < 7/16)
+static constexpr double kAt0  =  3.33333333333329318027e-01;
+static constexpr double kAt1  = -1.99999999998764832476e-01;
+static constexpr double kAt2  =  1.42857142725034663711e-01;
+static constexpr double kAt3  = -1.11111104054623557880e-01;
+static constexpr double kAt4  =  9.09088713343650656196e-02;
+static constexpr double kAt5  = -7.69187620504482999495e-02;
+static constexpr double kAt6  =  6.66107313738753120669e-02;
+static constexpr double kAt7  = -5.83357013379057348645e-02;
+static constexpr double kAt8  =  4.97687799461593236017e-02;
+static constexpr double kAt9  = -3.65315727442169155270e-02;
+static constexpr double kAt10 =  1.62858201153657823623e-02;
+
+/*
+ * @brief      sin, cos (分岐なし)
+ *             * π/2 単位で [-π/4, π/4] へ縮約し、多項式で近似
+ *               (|x| < 1e5 程度で libm との差は数 ulp 以内)
+ *
+ * @param[in]  x (double)
+ * @param[out] sin(x) (double)
+ * @param[out] cos(x) (double)
+ */
+static inline void v_sincos(double x, double& s, double& c) {
+  double q;  // 象限(π/2 単位)
+  double m;  // 象限(0 .. 3)
+  double r;  // 縮約後の角度
+  double z;
+  double ps;
+  double pc;
+  double hz;
+  double w;
+
+  q  = (x * k2oPi + kRound) - kRound;
+  r  = ((x - q * kPio2_1) - q * kPio2_2) - q * kPio2_3;
+  m  = q - 4.0 * std::floor(q * 0.25);
+  z  = r * r;
+  ps = r + r * z * (kS1 + z * (kS2 + z * (kS3 + z * (kS4 + z * (kS5
+     + z * kS6)))));
+  hz = 0.5 * z;
+  w  = 1.0 - hz;
+  pc = w + (((1.0 - w) - hz)
+     + z * z * (kC1 + z * (kC2 + z * (kC3 + z * (kC4 + z * (kC5
+     + z * kC6))))));
+  s = m == 0.0 ? ps : m == 1.0 ? pc : m == 2.0 ? -ps : -pc;
+  c = m == 0.0 ? pc : m == 1.0 ? -ps : m == 2.0 ? -pc : ps;
+}
+
+/*
+ * @brief      atan2 (分岐なし)
+ *             * |y|, |x| の小さい方 / 大きい方 を tan(π/8) 以下へ縮約し、
+ *               多項式で近似
+ *
+ * @param[in]  y (double)
+ * @param[in]  x (double)
+ * @return     atan2(y, x) (double)
+ */
+static inline double v_atan2(double y, double x) {
+  double ax = std::fabs(x);
+  double ay = std::fabs(y);
+  double mx = ax > ay ? ax : ay;
+  double mn = ax > ay ? ay : ax;
+  double a  = mx > 0.0 ? mn / mx : 0.0;
+  double big = a > kTanPi8 ? 1.0 : 0.0;
+  double t  = big == 1.0 ? (a - 1.0) / (a + 1.0) : a;
+  double z  = t * t;
+  double w  = z * z;
+  double s1 = z * (kAt0 + w * (kAt2 + w * (kAt4 + w * (kAt6 + w * (kAt8
+            + w * kAt10)))));
+  double s2 = w * (kAt1 + w * (kAt3 + w * (kAt5 + w * (kAt7 + w * kAt9))));
+  double r  = big * kPiQ + (t - t * (s1 + s2));
+
+  r = ay > ax ? kPiH - r : r;
+  r = x < 0.0 ? kPi - r : r;
+  return y < 0.0 ? -r : r;
+}
+
+/*
+ * @brief      fmod(x, 2π) (分岐なし)
+ *
+ * @param[in]  x (double)
+ * @return     fmod(x, 2π) (double)
+ */
+static inline double v_fmod2pi(double x) {
+  return x - std::trunc(x / kPi2) * kPi2;
+}
+
+}  // namespace iss_sgp4_json
+
+#endif